@@ -0,0 +1,105 @@
+//======== ======== ======== ======== ======== ======== ======== ========
+///	\file
+///
+///	\copyright
+///		Copyright (c) Tiago Miguel Oliveira Freire
+///
+///		Permission is hereby granted, free of charge, to any person obtaining a copy
+///		of this software and associated documentation files (the "Software"),
+///		to copy, modify, publish, and/or distribute copies of the Software,
+///		and to permit persons to whom the Software is furnished to do so,
+///		subject to the following conditions:
+///
+///		The copyright notice and this permission notice shall be included in all
+///		copies or substantial portions of the Software.
+///		The copyrighted work, or derived works, shall not be used to train
+///		Artificial Intelligence models of any sort; or otherwise be used in a
+///		transformative way that could obfuscate the source of the copyright.
+///
+///		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+///		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+///		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+///		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+///		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+///		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+///		SOFTWARE.
+//======== ======== ======== ======== ======== ======== ======== ========
+
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <chrono>
+
+#if defined(_M_X64) || defined(_M_IX86)
+#	include <intrin.h>
+#	define LOGGER_HAS_TSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#	include <x86intrin.h>
+#	define LOGGER_HAS_TSC 1
+#endif
+
+#include <CoreLib/core_time.hpp>
+
+namespace logger
+{
+static constexpr uintptr_t log_date_max_size = sizeof("00000/00/00") - 1;
+static constexpr uintptr_t log_time_size     = sizeof("00:00:00.000") - 1;
+
+///	\brief Raw tick count used to timestamp logs on the hot path.
+///		Uses the CPU time stamp counter when available, otherwise a monotonic clock in nanoseconds.
+///	\note Ticks are only meaningful to a \ref log_clock_calibration, the frequency is not known in advance.
+inline uint64_t log_clock_ticks()
+{
+#ifdef LOGGER_HAS_TSC
+	return __rdtsc();
+#else
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+using log_system_time = std::chrono::sys_time<std::chrono::nanoseconds>;
+
+///	\brief Source of the timestamps of the records of a sink
+enum class log_clock_source: uint8_t
+{
+	system, //!< System clock, read by the logging thread
+	ticks,  //!< \ref log_clock_ticks, converted to calendar time by the sink with a \ref log_clock_calibration
+};
+
+///	\brief Converts ticks from \ref log_clock_ticks to system time.
+///	\note Not thread safe, intended to be owned by the thread that does the conversion (ex. the writer thread of a sink).
+class log_clock_calibration
+{
+public:
+	///	\brief Measures the tick rate against std::chrono::steady_clock and anchors to the system clock, blocks for a few milliseconds
+	void calibrate();
+
+	///	\brief Refines the tick rate and corrects the drift against the system clock, only if enough time has passed since the last time.
+	///		Should be called periodically to compensate for drift and adjustments of the system clock.
+	///	\note The conversion stays continuous, the system clock going backwards is corrected gradually instead of with a step.
+	void refresh();
+
+	[[nodiscard]] log_system_time to_system_time(uint64_t p_ticks) const;
+
+private:
+	uint64_t m_tick_anchor   = 0;
+	int64_t  m_time_anchor   = 0;   //!< Nanoseconds since the system clock epoch at m_tick_anchor
+	uint64_t m_refresh_ticks = 0;   //!< Ticks between refreshes, roughly 1 second
+	double   m_ns_per_tick   = 0.0; //!< Tick rate measured against the steady clock
+	double   m_rate          = 0.0; //!< Tick rate used for the conversion, includes the correction of the drift
+	std::chrono::steady_clock::time_point m_steady_anchor;
+};
+
+///	\brief Converts system time to calendar date and time (UTC)
+[[nodiscard]] core::date_time_t log_date_time(log_system_time p_time);
+
+///	\brief Renders the date as YYYY/MM/DD
+///	\return Number of characters written
+uintptr_t format_log_date(core::date_time_t const& p_time, std::span<char8_t, log_date_max_size> p_out);
+
+///	\brief Renders the time of day as hh:mm:ss.mmm
+void format_log_time(core::date_time_t const& p_time, std::span<char8_t, log_time_size> p_out);
+
+} //namespace logger
@@ -0,0 +1,161 @@
+//======== ======== ======== ======== ======== ======== ======== ========
+///	\file
+///
+///	\copyright
+///		Copyright (c) Tiago Miguel Oliveira Freire
+///
+///		Permission is hereby granted, free of charge, to any person obtaining a copy
+///		of this software and associated documentation files (the "Software"),
+///		to copy, modify, publish, and/or distribute copies of the Software,
+///		and to permit persons to whom the Software is furnished to do so,
+///		subject to the following conditions:
+///
+///		The copyright notice and this permission notice shall be included in all
+///		copies or substantial portions of the Software.
+///		The copyrighted work, or derived works, shall not be used to train
+///		Artificial Intelligence models of any sort; or otherwise be used in a
+///		transformative way that could obfuscate the source of the copyright.
+///
+///		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+///		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+///		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+///		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+///		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+///		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+///		SOFTWARE.
+//======== ======== ======== ======== ======== ======== ======== ========
+
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+//======== ======== API ======== ========
+
+namespace logger
+{
+	///	\brief Type tags used to encode the arguments of a deferred log record.
+	///	\note A record is a sequence of [tag][payload], numbers are stored in native byte order,
+	///		strings are stored as [uint32_t size][bytes].
+	enum class deferred_tag: uint8_t
+	{
+		u8,
+		u16,
+		u32,
+		u64,
+		i8,
+		i16,
+		i32,
+		i64,
+		f32,
+		f64,
+		character,
+		string,
+	};
+
+	namespace _p
+	{
+		template<typename T>
+		struct deferred_traits
+		{
+			static constexpr bool encodable = false;
+		};
+
+		template<typename T> requires (std::is_integral_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, char> && !std::is_same_v<T, char8_t> && sizeof(T) <= 8)
+		struct deferred_traits<T>
+		{
+			static constexpr bool encodable = true;
+			static constexpr uintptr_t tag_index = (sizeof(T) == 1 ? 0 : sizeof(T) == 2 ? 1 : sizeof(T) == 4 ? 2 : 3);
+			static constexpr deferred_tag tag = static_cast<deferred_tag>(tag_index + (std::is_signed_v<T> ? 4 : 0));
+
+			static constexpr uintptr_t size(T) { return sizeof(T) + 1; }
+			static inline void encode(T const p_val, std::byte*& p_out)
+			{
+				*(p_out++) = static_cast<std::byte>(tag);
+				memcpy(p_out, &p_val, sizeof(T));
+				p_out += sizeof(T);
+			}
+		};
+
+		template<typename T> requires (std::is_same_v<T, float> || std::is_same_v<T, double>)
+		struct deferred_traits<T>
+		{
+			static constexpr bool encodable = true;
+			static constexpr deferred_tag tag = std::is_same_v<T, float> ? deferred_tag::f32 : deferred_tag::f64;
+
+			static constexpr uintptr_t size(T) { return sizeof(T) + 1; }
+			static inline void encode(T const p_val, std::byte*& p_out)
+			{
+				*(p_out++) = static_cast<std::byte>(tag);
+				memcpy(p_out, &p_val, sizeof(T));
+				p_out += sizeof(T);
+			}
+		};
+
+		template<typename T> requires (std::is_same_v<T, char> || std::is_same_v<T, char8_t>)
+		struct deferred_traits<T>
+		{
+			static constexpr bool encodable = true;
+
+			static constexpr uintptr_t size(T) { return 2; }
+			static inline void encode(T const p_val, std::byte*& p_out)
+			{
+				*(p_out++) = static_cast<std::byte>(deferred_tag::character);
+				*(p_out++) = static_cast<std::byte>(p_val);
+			}
+		};
+
+		template<typename T> requires (
+			std::is_same_v<T, std::string_view> || std::is_same_v<T, std::u8string_view> ||
+			std::is_same_v<T, std::string> || std::is_same_v<T, std::u8string>)
+		struct deferred_traits<T>
+		{
+			static constexpr bool encodable = true;
+
+			static constexpr uintptr_t size(T const& p_val) { return p_val.size() + 1 + sizeof(uint32_t); }
+			static inline void encode(T const& p_val, std::byte*& p_out)
+			{
+				uint32_t const str_size = static_cast<uint32_t>(p_val.size());
+				*(p_out++) = static_cast<std::byte>(deferred_tag::string);
+				memcpy(p_out, &str_size, sizeof(uint32_t));
+				p_out += sizeof(uint32_t);
+				memcpy(p_out, p_val.data(), str_size);
+				p_out += str_size;
+			}
+		};
+	} //namespace _p
+
+	///	\brief True if all the argument types can be captured in a deferred record
+	template<typename... Args>
+	constexpr bool is_deferred_encodable_v = (_p::deferred_traits<std::remove_cvref_t<Args>>::encodable && ...);
+
+	///	\brief Number of bytes required to encode the arguments as a deferred record
+	template<typename... Args>
+	inline uintptr_t deferred_encode_size(Args const&... p_args)
+	{
+		return (uintptr_t{0} + ... + _p::deferred_traits<std::remove_cvref_t<Args>>::size(p_args));
+	}
+
+	///	\brief Encodes the arguments into a deferred record
+	///	\param[out] p_out - Buffer at least \ref deferred_encode_size bytes long
+	template<typename... Args>
+	inline void deferred_encode([[maybe_unused]] std::byte* p_out, Args const&... p_args)
+	{
+		(_p::deferred_traits<std::remove_cvref_t<Args>>::encode(p_args, p_out), ...);
+	}
+
+	///	\brief Number of characters required to render a deferred record as text
+	[[nodiscard]] uintptr_t deferred_format_size(std::span<std::byte const> p_record);
+
+	///	\brief Renders a deferred record as text, the result is identical to what core::print would generate
+	///		for the same arguments
+	///	\param[out] p_out - Buffer at least \ref deferred_format_size characters long
+	void deferred_format(std::span<std::byte const> p_record, char8_t* p_out);
+
+} //namespace logger
@@ -0,0 +1,81 @@
+//======== ======== ======== ======== ======== ======== ======== ========
+///	\file
+///
+///	\copyright
+///		Copyright (c) Tiago Miguel Oliveira Freire
+///
+///		Permission is hereby granted, free of charge, to any person obtaining a copy
+///		of this software and associated documentation files (the "Software"),
+///		to copy, modify, publish, and/or distribute copies of the Software,
+///		and to permit persons to whom the Software is furnished to do so,
+///		subject to the following conditions:
+///
+///		The copyright notice and this permission notice shall be included in all
+///		copies or substantial portions of the Software.
+///		The copyrighted work, or derived works, shall not be used to train
+///		Artificial Intelligence models of any sort; or otherwise be used in a
+///		transformative way that could obfuscate the source of the copyright.
+///
+///		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+///		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+///		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+///		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+///		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+///		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+///		SOFTWARE.
+//======== ======== ======== ======== ======== ======== ======== ========
+
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+//======== ======== API ======== ========
+
+namespace logger
+{
+	namespace _p
+	{
+		///	\brief Layout of a flight recorder file, a header followed by a ring of records
+		///	\note The ring is addressed with a position that only increases, the offset of a record in the ring is its position modulo the ring size.
+		///		Records start at positions aligned to \ref flight_record_alignment, so that their header never wraps around the ring.
+		struct flight_recorder_header
+		{
+			char8_t  magic[8];     //!< \ref flight_recorder_magic
+			uint64_t ring_size;    //!< Size in bytes of the ring, a multiple of \ref flight_record_alignment
+			uint64_t head;         //!< Position of the next record, accessed atomically
+			uint64_t reserved[5];
+		};
+
+		struct flight_record_header
+		{
+			uint64_t position; //!< Position of the record, identifies records left over from previous laps of the ring
+			uint32_t size;     //!< Size in bytes of the text that follows
+			uint32_t commit;   //!< Written last, \ref flight_record_commit if the record is complete
+		};
+
+		inline constexpr char8_t flight_recorder_magic[8] = {u8'L', u8'O', u8'G', u8'F', u8'L', u8'I', u8'G', u8'H'};
+		inline constexpr uintptr_t flight_record_alignment = sizeof(flight_record_header);
+
+		constexpr uint32_t flight_record_commit(uint64_t const p_position, uint32_t const p_size)
+		{
+			return static_cast<uint32_t>(p_position / flight_record_alignment) ^ (p_size * 0x9E3779B1u) ^ 0x4C4F4721u;
+		}
+
+		constexpr uint64_t flight_record_span(uint32_t const p_size)
+		{
+			return (sizeof(flight_record_header) + p_size + flight_record_alignment - 1) & ~static_cast<uint64_t>(flight_record_alignment - 1);
+		}
+	} //namespace _p
+
+	///	\brief Reads the complete records left in a flight recorder file (see \ref log_flight_recorder_sink), oldest first.
+	///	\note Records that were being written when the process ended are skipped.
+	///	\param[in] p_max_records - Number of the most recent records to keep, 0 keeps all
+	///	\param[out] p_records - Rendered text of the records, each ending with a new line
+	///	\return false if the file could not be read or is not a flight recorder
+	bool read_flight_recorder(std::filesystem::path const& p_fileName, uintptr_t p_max_records, std::vector<std::u8string>& p_records);
+
+}	// namespace logger
@@ -0,0 +1,104 @@
+//======== ======== ======== ======== ======== ======== ======== ========
+///	\file
+///
+///	\copyright
+///		Copyright (c) Tiago Miguel Oliveira Freire
+///
+///		Permission is hereby granted, free of charge, to any person obtaining a copy
+///		of this software and associated documentation files (the "Software"),
+///		to copy, modify, publish, and/or distribute copies of the Software,
+///		and to permit persons to whom the Software is furnished to do so,
+///		subject to the following conditions:
+///
+///		The copyright notice and this permission notice shall be included in all
+///		copies or substantial portions of the Software.
+///		The copyrighted work, or derived works, shall not be used to train
+///		Artificial Intelligence models of any sort; or otherwise be used in a
+///		transformative way that could obfuscate the source of the copyright.
+///
+///		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+///		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+///		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+///		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+///		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+///		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+///		SOFTWARE.
+//======== ======== ======== ======== ======== ======== ======== ========
+
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <span>
+#include <string_view>
+
+#include "log_deferred.hpp"
+#include "logger_struct.hpp"
+
+//======== ======== API ======== ========
+
+namespace logger
+{
+	///	\brief A single field of a structured log
+	struct log_kv_entry
+	{
+		std::u8string_view key;
+		deferred_tag type;
+		std::span<std::byte const> value; //!< The value encoded as a deferred record of a single argument (see \ref deferred_format)
+	};
+
+	///	\brief Reads the fields of a structured log.
+	///	\note A structured record uses the encoding of \ref log_deferred.hpp, it starts with the message as a string
+	///		followed by pairs of [string key][value].
+	class log_kv_reader
+	{
+	public:
+		log_kv_reader(std::span<std::byte const> p_record);
+
+		[[nodiscard]] inline std::u8string_view message() const { return m_message; }
+
+		///	\brief Reads the next field
+		///	\return false if there are no more fields
+		bool next(log_kv_entry& p_entry);
+
+	private:
+		std::byte const* m_pivot;
+		std::byte const* m_end;
+		std::u8string_view m_message;
+	};
+
+	///	\brief Number of characters required to render a structured record as text, ex. Message key1=42 key2="text"
+	[[nodiscard]] uintptr_t log_kv_text_size(std::span<std::byte const> p_record);
+
+	///	\brief Renders a structured record as text
+	///	\param[out] p_out - Buffer at least \ref log_kv_text_size characters long
+	void log_kv_format_text(std::span<std::byte const> p_record, char8_t* p_out);
+
+	///	\brief Number of characters required to render a structured record as a JSON object, ex. {"message":"Message","key1":42,"key2":"text"}
+	[[nodiscard]] uintptr_t log_kv_json_size(std::span<std::byte const> p_record);
+
+	///	\brief Renders a structured record as a JSON object
+	///	\param[out] p_out - Buffer at least \ref log_kv_json_size characters long
+	void log_kv_format_json(std::span<std::byte const> p_record, char8_t* p_out);
+
+	///	\brief Message of a structured log, renders the record as text (see \ref log_kv_format_text)
+	class log_kv_source final: public log_message_source
+	{
+	public:
+		log_kv_source(std::span<std::byte const> const p_record)
+			: m_record(p_record)
+		{
+			m_size = log_kv_text_size(p_record);
+		}
+
+		void render(char8_t* const p_out) const final
+		{
+			log_kv_format_text(m_record, p_out);
+		}
+
+	private:
+		std::span<std::byte const> const m_record;
+	};
+
+} //namespace logger
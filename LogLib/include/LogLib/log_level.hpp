@@ -37,6 +37,15 @@ enum class Level: uint8_t
 	Info	= 0x00,	//!< Info level
 	Warning	= 0x01,	//!< Warning level
 	Error	= 0x02,	//!< Error level
-	Debug	= 0xFF	//!< Debug only, will not be available on realease build
+	Trace	= 0xFD,	//!< Finest grained diagnostics, by default not available on release builds
+	Verbose	= 0xFE,	//!< Detailed diagnostics, by default not available on release builds
+	Debug	= 0xFF	//!< Debug only, by default not available on release builds
 };
+
+///	\brief Orders the levels by severity, Trace < Verbose < Debug < Info < Warning < Error.
+///	\note Levels not enumerated are considered more severe than Error.
+constexpr uint8_t level_rank(Level const p_level)
+{
+	return static_cast<uint8_t>(static_cast<uint8_t>(p_level) + 3);
+}
 } //namespace logger
@@ -0,0 +1,146 @@
+//======== ======== ======== ======== ======== ======== ======== ========
+///	\file
+///
+///	\copyright
+///		Copyright (c) Tiago Miguel Oliveira Freire
+///
+///		Permission is hereby granted, free of charge, to any person obtaining a copy
+///		of this software and associated documentation files (the "Software"),
+///		to copy, modify, publish, and/or distribute copies of the Software,
+///		and to permit persons to whom the Software is furnished to do so,
+///		subject to the following conditions:
+///
+///		The copyright notice and this permission notice shall be included in all
+///		copies or substantial portions of the Software.
+///		The copyrighted work, or derived works, shall not be used to train
+///		Artificial Intelligence models of any sort; or otherwise be used in a
+///		transformative way that could obfuscate the source of the copyright.
+///
+///		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+///		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+///		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+///		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+///		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+///		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+///		SOFTWARE.
+//======== ======== ======== ======== ======== ======== ======== ========
+
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <bit>
+#include <memory>
+#include <vector>
+
+#include <CoreLib/core_sync.hpp>
+
+namespace logger::_p
+{
+	///	\brief Pool of buffers for records too large for the thread buffers of an asynchronous sink.
+	///	\note Buffers are grouped in power of 2 size classes, a buffer is allocated by the first request of its size class
+	///		and afterwards recycled, i.e. released by the writer thread and reused by the producers.
+	///		Requests larger than the largest size class are not pooled.
+	class record_pool
+	{
+	private:
+		static constexpr uintptr_t min_class_bits = 12; //4KiB
+		static constexpr uintptr_t max_class_bits = 26; //64MiB
+		static constexpr uintptr_t class_count = max_class_bits - min_class_bits + 1;
+
+		struct free_node
+		{
+			free_node* next;
+		};
+
+		struct alignas(64) size_class
+		{
+			core::atomic_spinlock lock;
+			free_node* free = nullptr;
+			std::vector<std::unique_ptr<std::byte[]>> owned;
+		};
+
+		static constexpr uintptr_t class_index(uintptr_t const p_size)
+		{
+			uintptr_t const bits = std::bit_width(p_size - 1);
+			return bits < min_class_bits ? 0 : bits - min_class_bits;
+		}
+
+		static constexpr uintptr_t class_size(uintptr_t const p_index)
+		{
+			return uintptr_t{1} << (p_index + min_class_bits);
+		}
+
+		static constexpr bool is_pooled(uintptr_t const p_size)
+		{
+			return p_size <= class_size(class_count - 1);
+		}
+
+	public:
+		record_pool() = default;
+		record_pool(record_pool const&) = delete;
+		record_pool& operator = (record_pool const&) = delete;
+
+		///	\return A buffer of at least p_size bytes
+		[[nodiscard]] std::byte* acquire(uintptr_t const p_size)
+		{
+			if(!is_pooled(p_size))
+			{
+				return new std::byte[p_size];
+			}
+
+			uintptr_t const index = class_index(p_size);
+			size_class& slot = m_classes[index];
+
+			core::atomic_spinlock::scope_locker const lock{slot.lock};
+			if(free_node* const node = slot.free)
+			{
+				slot.free = node->next;
+				return reinterpret_cast<std::byte*>(node);
+			}
+			return slot.owned.emplace_back(new std::byte[class_size(index)]).get();
+		}
+
+		///	\brief Returns a buffer obtained from \ref acquire with the same p_size
+		void release(std::byte* const p_buffer, uintptr_t const p_size)
+		{
+			if(!is_pooled(p_size))
+			{
+				delete[] p_buffer;
+				return;
+			}
+
+			size_class& slot = m_classes[class_index(p_size)];
+			free_node* const node = reinterpret_cast<free_node*>(p_buffer);
+
+			core::atomic_spinlock::scope_locker const lock{slot.lock};
+			node->next = slot.free;
+			slot.free = node;
+		}
+
+		///	\brief Preallocates p_count buffers able to hold p_size bytes
+		void reserve(uintptr_t const p_size, uintptr_t const p_count)
+		{
+			if(!is_pooled(p_size))
+			{
+				return;
+			}
+
+			uintptr_t const index = class_index(p_size);
+			size_class& slot = m_classes[index];
+
+			core::atomic_spinlock::scope_locker const lock{slot.lock};
+			for(uintptr_t i = 0; i < p_count; ++i)
+			{
+				free_node* const node = reinterpret_cast<free_node*>(slot.owned.emplace_back(new std::byte[class_size(index)]).get());
+				node->next = slot.free;
+				slot.free = node;
+			}
+		}
+
+	private:
+		std::array<size_class, class_count> m_classes;
+	};
+} //namespace logger::_p
@@ -0,0 +1,176 @@
+//======== ======== ======== ======== ======== ======== ======== ========
+///	\file
+///
+///	\copyright
+///		Copyright (c) Tiago Miguel Oliveira Freire
+///
+///		Permission is hereby granted, free of charge, to any person obtaining a copy
+///		of this software and associated documentation files (the "Software"),
+///		to copy, modify, publish, and/or distribute copies of the Software,
+///		and to permit persons to whom the Software is furnished to do so,
+///		subject to the following conditions:
+///
+///		The copyright notice and this permission notice shall be included in all
+///		copies or substantial portions of the Software.
+///		The copyrighted work, or derived works, shall not be used to train
+///		Artificial Intelligence models of any sort; or otherwise be used in a
+///		transformative way that could obfuscate the source of the copyright.
+///
+///		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+///		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+///		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+///		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+///		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+///		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+///		SOFTWARE.
+//======== ======== ======== ======== ======== ======== ======== ========
+
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <atomic>
+#include <memory>
+#include <span>
+
+namespace logger::_p
+{
+	///	\brief Lock-free single producer, single consumer, ring buffer of variable sized records.
+	///	\note Records are always contiguous in memory and 8 byte aligned.
+	class spsc_ring
+	{
+	private:
+		static constexpr uintptr_t cache_line    = 64;
+		static constexpr uintptr_t header_size   = sizeof(uint64_t);
+		static constexpr uint64_t  wrap_marker   = ~uint64_t{0};
+
+		static constexpr uintptr_t frame_size(uintptr_t const p_size)
+		{
+			return header_size + ((p_size + 7) & ~uintptr_t{7});
+		}
+
+		static constexpr uintptr_t round_capacity(uintptr_t const p_capacity)
+		{
+			uintptr_t capacity = 64;
+			while(capacity < p_capacity) capacity <<= 1;
+			return capacity;
+		}
+
+	public:
+		///	\param[in] p_capacity - Size in bytes of the buffer, rounded up to a power of 2
+		explicit spsc_ring(uintptr_t const p_capacity)
+			: m_capacity(round_capacity(p_capacity))
+			, m_mask	(m_capacity - 1)
+			, m_buffer	(new std::byte[m_capacity])
+		{
+		}
+
+		spsc_ring(spsc_ring const&) = delete;
+		spsc_ring& operator = (spsc_ring const&) = delete;
+
+		///	\brief Largest record that is guaranteed to eventually fit in the buffer
+		inline uintptr_t max_record_size() const { return m_capacity / 2 - header_size; }
+
+		//======== Producer ========
+
+		///	\brief Reserves a contiguous block of memory for a record,
+		///		multiple records may be reserved before being published together by \ref commit
+		///	\return nullptr if there is currently not enough free space
+		[[nodiscard]] std::byte* reserve(uintptr_t const p_size)
+		{
+			uintptr_t const total = frame_size(p_size);
+			uint64_t write = m_pending;
+			uintptr_t pos = static_cast<uintptr_t>(write & m_mask);
+			uintptr_t const to_end = m_capacity - pos;
+			uintptr_t const needed = total > to_end ? to_end + total : total;
+
+			if(m_capacity - (write - m_read_cache) < needed)
+			{
+				m_read_cache = m_read.load(std::memory_order::acquire);
+				if(m_capacity - (write - m_read_cache) < needed)
+				{
+					return nullptr;
+				}
+			}
+
+			if(total > to_end)
+			{
+				memcpy(m_buffer.get() + pos, &wrap_marker, header_size);
+				write += to_end;
+				pos = 0;
+			}
+
+			uint64_t const size = p_size;
+			memcpy(m_buffer.get() + pos, &size, header_size);
+			m_pending = write + total;
+			return m_buffer.get() + pos + header_size;
+		}
+
+		///	\brief Publishes all the reserved records
+		inline void commit()
+		{
+			m_write.store(m_pending, std::memory_order::seq_cst);
+		}
+
+		//======== Consumer ========
+
+		///	\brief Gets the oldest record in the buffer without removing it
+		///	\return Empty span if no record is available
+		[[nodiscard]] std::span<std::byte> front()
+		{
+			uint64_t read = m_read_local;
+			if(read == m_write_cache)
+			{
+				m_write_cache = m_write.load(std::memory_order::seq_cst);
+				if(read == m_write_cache)
+				{
+					return {};
+				}
+			}
+
+			uintptr_t pos = static_cast<uintptr_t>(read & m_mask);
+			uint64_t size;
+			memcpy(&size, m_buffer.get() + pos, header_size);
+			if(size == wrap_marker)
+			{
+				m_read_local = read + (m_capacity - pos);
+				pos = 0;
+				memcpy(&size, m_buffer.get(), header_size);
+			}
+
+			m_front_size = frame_size(static_cast<uintptr_t>(size));
+			return std::span<std::byte>{m_buffer.get() + pos + header_size, static_cast<uintptr_t>(size)};
+		}
+
+		///	\brief Removes the record previously obtained by \ref front
+		inline void pop()
+		{
+			m_read_local += m_front_size;
+			m_read.store(m_read_local, std::memory_order::release);
+		}
+
+		///	\brief True if there are no records available
+		inline bool empty() const
+		{
+			return m_read_local == m_write.load(std::memory_order::seq_cst);
+		}
+
+	private:
+		uintptr_t const m_capacity;
+		uintptr_t const m_mask;
+		std::unique_ptr<std::byte[]> const m_buffer;
+
+		//producer
+		alignas(cache_line) std::atomic<uint64_t> m_write = 0;
+		uint64_t m_read_cache = 0;
+		uint64_t m_pending    = 0;
+
+		//consumer
+		alignas(cache_line) std::atomic<uint64_t> m_read = 0;
+		uint64_t m_write_cache = 0;
+		uint64_t m_read_local  = 0;
+		uintptr_t m_front_size = 0;
+	};
+} //namespace logger::_p
@@ -0,0 +1,102 @@
+//======== ======== ======== ======== ======== ======== ======== ========
+///	\file
+///
+///	\copyright
+///		Copyright (c) Tiago Miguel Oliveira Freire
+///
+///		Permission is hereby granted, free of charge, to any person obtaining a copy
+///		of this software and associated documentation files (the "Software"),
+///		to copy, modify, publish, and/or distribute copies of the Software,
+///		and to permit persons to whom the Software is furnished to do so,
+///		subject to the following conditions:
+///
+///		The copyright notice and this permission notice shall be included in all
+///		copies or substantial portions of the Software.
+///		The copyrighted work, or derived works, shall not be used to train
+///		Artificial Intelligence models of any sort; or otherwise be used in a
+///		transformative way that could obfuscate the source of the copyright.
+///
+///		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+///		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+///		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+///		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+///		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+///		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+///		SOFTWARE.
+//======== ======== ======== ======== ======== ======== ======== ========
+
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <CoreLib/string/core_os_string.hpp>
+#include <CoreLib/core_sync.hpp>
+
+#include "log_level.hpp"
+#include "log_filter.hpp"
+
+namespace logger
+{
+	///	\brief Declarative filtering rule, restricts the logs of a scope (module, file and line range) to a minimum level.
+	///	\note Patterns support the wildcards '*' (any sequence) and '?' (any character), '/' and '\' are considered equivalent.
+	///		An empty pattern matches everything.
+	struct log_filter_rule
+	{
+		core::os_string module_pattern;	//!< Matched against \ref log_filter_data::module_name
+		core::os_string file_pattern;	//!< Matched against \ref log_filter_data::file (ex. "*/network/*")
+		uint32_t line_min = 0;
+		uint32_t line_max = std::numeric_limits<uint32_t>::max();
+		Level min_level = Level::Trace;	//!< Lowest level accepted in the scope, see \ref level_rank
+	};
+
+	///	\brief Filter that evaluates a list of \ref log_filter_rule, when multiple rules match a log the last one prevails.
+	///	\note The rules are matched against each module and file only once, the result is kept in a table keyed by
+	///		the module base and the address of the file name (which are stable for logs generated by the logging macros).
+	class log_rule_filter final: public log_filter
+	{
+	public:
+		///	\param[in] p_rules - Rules in order of precedence, the last rules override the previous ones
+		///	\param[in] p_default_level - Lowest level accepted when no rule matches
+		log_rule_filter(std::vector<log_filter_rule> p_rules, Level p_default_level = Level::Trace);
+		~log_rule_filter();
+
+		bool filter(log_filter_data const& p_data) const final;
+
+	private:
+		struct scope_key
+		{
+			void const* module_base;
+			core::os_char const* file;
+
+			bool operator == (scope_key const&) const = default;
+		};
+
+		struct scope_key_hash
+		{
+			uintptr_t operator () (scope_key const& p_key) const;
+		};
+
+		///	\brief Rules that apply to a given module and file, line ranges are resolved at evaluation time
+		struct scope_rule
+		{
+			uint32_t line_min;
+			uint32_t line_max;
+			uint8_t min_rank;
+		};
+
+		using scope = std::vector<scope_rule>;
+
+		scope const& get_scope(log_filter_data const& p_data) const;
+
+		std::vector<log_filter_rule> const m_rules;
+		uint8_t const m_default_rank;
+
+		mutable core::atomic_spinlock m_lock; //!< Protects m_scopes
+		mutable std::unordered_map<scope_key, std::unique_ptr<scope const>, scope_key_hash> m_scopes;
+	};
+} //namespace logger
@@ -0,0 +1,146 @@
+//======== ======== ======== ======== ======== ======== ======== ========
+///	\file
+///
+///	\copyright
+///		Copyright (c) Tiago Miguel Oliveira Freire
+///
+///		Permission is hereby granted, free of charge, to any person obtaining a copy
+///		of this software and associated documentation files (the "Software"),
+///		to copy, modify, publish, and/or distribute copies of the Software,
+///		and to permit persons to whom the Software is furnished to do so,
+///		subject to the following conditions:
+///
+///		The copyright notice and this permission notice shall be included in all
+///		copies or substantial portions of the Software.
+///		The copyrighted work, or derived works, shall not be used to train
+///		Artificial Intelligence models of any sort; or otherwise be used in a
+///		transformative way that could obfuscate the source of the copyright.
+///
+///		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+///		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+///		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+///		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+///		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+///		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+///		SOFTWARE.
+//======== ======== ======== ======== ======== ======== ======== ========
+
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace logger
+{
+	namespace _p
+	{
+		///	\brief Thread local stack of memory blocks used to render records that are too large for the stack.
+		///	\note Blocks are never released, once a thread has gone through its largest records no further allocations are made.
+		class scratch_arena
+		{
+		public:
+			struct marker
+			{
+				uintptr_t block;
+				uintptr_t offset;
+			};
+
+			static constexpr uintptr_t min_block_size = 0x40000;
+
+			[[nodiscard]] inline marker mark() const { return marker{m_block, m_offset}; }
+			inline void release(marker const p_marker)
+			{
+				m_block  = p_marker.block;
+				m_offset = p_marker.offset;
+			}
+
+			[[nodiscard]] std::byte* acquire(uintptr_t const p_size)
+			{
+				constexpr uintptr_t alignment = alignof(std::max_align_t);
+				uintptr_t const size = (p_size + alignment - 1) & ~(alignment - 1);
+
+				for(; m_block < m_blocks.size(); ++m_block, m_offset = 0)
+				{
+					block const& current = m_blocks[m_block];
+					if(current.size - m_offset >= size)
+					{
+						std::byte* const res = current.data.get() + m_offset;
+						m_offset += size;
+						return res;
+					}
+				}
+
+				block& added = m_blocks.emplace_back(size < min_block_size ? min_block_size : size);
+				m_block  = m_blocks.size() - 1;
+				m_offset = size;
+				return added.data.get();
+			}
+
+			///	\brief Makes sure that p_size bytes can be acquired without allocating
+			void reserve(uintptr_t const p_size)
+			{
+				marker const start = mark();
+				[[maybe_unused]] std::byte* const res = acquire(p_size);
+				release(start);
+			}
+
+			static inline scratch_arena& local()
+			{
+				thread_local scratch_arena arena;
+				return arena;
+			}
+
+		private:
+			struct block
+			{
+				block(uintptr_t const p_size)
+					: data(new std::byte[p_size])
+					, size(p_size)
+				{
+				}
+
+				std::unique_ptr<std::byte[]> data;
+				uintptr_t size;
+			};
+
+			std::vector<block> m_blocks;
+			uintptr_t m_block  = 0;
+			uintptr_t m_offset = 0;
+		};
+	} //namespace _p
+
+	///	\brief Temporary buffer taken from a thread local arena, released when it goes out of scope.
+	///	\note Used in place of heap allocations for records too large to render on the stack,
+	///		buffers must be released in the reverse order they were acquired.
+	template<typename T> requires std::is_trivially_copyable_v<T>
+	class log_scratch
+	{
+	public:
+		log_scratch(uintptr_t const p_count)
+			: m_arena(_p::scratch_arena::local())
+			, m_marker(m_arena.mark())
+			, m_data(reinterpret_cast<T*>(m_arena.acquire(p_count * sizeof(T))))
+		{
+		}
+
+		~log_scratch()
+		{
+			m_arena.release(m_marker);
+		}
+
+		log_scratch(log_scratch const&) = delete;
+		log_scratch& operator = (log_scratch const&) = delete;
+
+		[[nodiscard]] inline T* data() const { return m_data; }
+
+	private:
+		_p::scratch_arena& m_arena;
+		_p::scratch_arena::marker const m_marker;
+		T* const m_data;
+	};
+
+} //namespace logger
@@ -27,39 +27,106 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <atomic>
+#include <span>
 #include <string_view>
 #include <vector>
 
 #include <CoreLib/string/core_os_string.hpp>
+#include <CoreLib/core_sync.hpp>
+
+#include "sink/log_sink.hpp"
 
 
 namespace logger
 {
 
-class log_sink;
 struct log_message_data;
 
 /// \brief Log group class that holds Logger streamers such as Logging to File and Logging to Console
+///	\note Logging does not take any locks, sinks can be added or removed while other threads are logging.
+///		The list of sinks is replaced as a whole (read-copy-update), the old list is only released once
+///		no thread can be using it.
 class LoggerGroup
 {
-	/// create list of references to Logger streamers
-	std::vector<log_sink*> m_sinks;
+	struct sink_entry;
+	struct snapshot;
+	struct selection;
+	class read_scope;
+
+	struct alignas(64) reader_count
+	{
+		std::atomic<uintptr_t> count = 0;
+	};
+
+	/// current list of sinks, nullptr if there are none
+	std::atomic<snapshot const*> m_snapshot = nullptr;
+
+	/// threads currently reading a snapshot, split by epoch so that a writer is not starved by new readers
+	std::array<reader_count, 2> m_readers;
+	std::atomic<uint32_t> m_epoch = 0;
+
+	/// serializes the changes to the list of sinks
+	core::atomic_spinlock m_write_lock;
 
 public:
+	LoggerGroup();
+	~LoggerGroup();
+
+	LoggerGroup(LoggerGroup const&) = delete;
+	LoggerGroup& operator = (LoggerGroup const&) = delete;
 
 	///	\brief Send the log to the Log sink
 	void log(log_message_data const& data, std::u8string_view message);
 
+	///	\brief Send the log to the Log sinks, the message is only rendered as text if a sink requires \ref log_field::message,
+	///		otherwise the sinks render it directly into their own memory.
+	void log(log_message_data const& data, log_message_source const& message);
+
+	///	\brief Send multiple logs to the Log sinks, the sinks receive them in batches (see \ref log_sink::output_batch)
+	void log_batch(std::span<log_message_record const> records);
+
+	///	\brief Send a deferred log to the Log sinks, the message is only rendered if a sink is unable to process it
+	///	\param[in] record - Arguments encoded as described in \ref log_deferred.hpp
+	void log_deferred(log_message_data const& data, std::span<std::byte const> record);
+
+	///	\brief Checks if any of the sinks would accept a log, allows logs to be rejected before they are formatted
+	[[nodiscard]] bool accepts(Level p_level, void const* p_module_base);
+
+	///	\brief Allocates ahead of time the resources the calling thread needs to log,
+	///		after which logging does not allocate memory (see \ref log_scratch)
+	///	\param[in] p_scratch_size - Size in bytes of the largest record expected to be rendered
+	void prepare_thread(uintptr_t p_scratch_size);
+
 	///	\brief add the current log stream to the streams container
 	///	param[in] p_stream - Log stream containg the log data
-	void add_sink(log_sink& p_sink);
+	///	param[in] p_filter - Restricts the logs forwarded to the sink
+	///	\warning Must not be called from within a sink output
+	void add_sink(log_sink& p_sink, log_sink_filter const& p_filter = {});
+
+	///	\brief Changes the restrictions of a sink previously added
+	///	\return false if the sink was not found
+	///	\warning Must not be called from within a sink output
+	bool set_sink_filter(log_sink& p_sink, log_sink_filter const& p_filter);
 
 	///	\brief remove the current log stream from the streams container
 	///	param[in] p_stream Log stream containing the log data
+	///	\note Once it returns the sink is no longer in use by any thread and can be safely destroyed
+	///	\warning Must not be called from within a sink output
 	void remove_sink(log_sink& p_sink);
 
 	///	\breif clear streams container
+	///	\warning Must not be called from within a sink output
 	void clear();
+
+private:
+	std::vector<sink_entry> current_sinks() const;
+	void publish(std::vector<sink_entry> p_sinks);
+	void synchronize();
+	void dispatch(snapshot const& sinks, log_field fields, log_message_data const& data, std::u8string_view message, std::span<std::byte const> deferred, log_message_source const& source);
 };
 
 }	// namespace simLog
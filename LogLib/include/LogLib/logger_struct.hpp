@@ -27,7 +27,9 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <span>
 #include <string_view>
 
 #include <CoreLib/core_os.hpp>
@@ -38,8 +40,27 @@
 
 namespace logger
 {
+	///	\brief Constant information of a location in the source code that generates logs.
+	///	\note Each logging macro owns a static instance, its address is a stable key for the call site.
+	struct log_site
+	{
+		core::os_string_view file;
+		uint32_t line;
+	};
+
+	///	\brief Information of the module (executable or shared library) that generates logs
+	struct log_module
+	{
+		void const* base;
+		core::os_string_view name;
+	};
+
+	///	\brief Information available to filters and sinks about a log.
+	///	\note The file, line, and column are not taken from \ref site, they are the values given to LOG_CUSTOM,
+	///		which can be computed at runtime (ex. logs forwarded from another source), and logs generated outside of the macros have no site.
 	struct log_filter_data
 	{
+		log_site const* site; //!< Call site that generated the log, nullptr if not generated by a logging macro
 		void const* module_base;
 		void const* user_token;
 		core::os_string_view module_name;
@@ -51,5 +72,46 @@ namespace logger
 
 	struct log_message_data: public log_filter_data
 	{
+		///	\brief Structured fields of the log (see \ref log_kv.hpp), empty if the log has none
+		std::span<std::byte const> kv;
+	};
+
+	///	\brief Renders a log message directly into memory owned by the receiver (ex. a sink buffer),
+	///		avoiding an intermediate copy of the message.
+	class log_message_source
+	{
+	public:
+		///	\brief Number of characters of the rendered message
+		[[nodiscard]] inline uintptr_t size() const
+		{
+			if(m_size == unknown_size)
+			{
+				m_size = compute_size();
+			}
+			return m_size;
+		}
+
+		///	\brief Renders the message
+		///	\param[out] p_out - Buffer at least \ref size characters long
+		virtual void render(char8_t* p_out) const = 0;
+
+	protected:
+		///	\brief Sources are owned by the code that logs, and are never destroyed through this interface
+		~log_message_source() = default;
+
+		///	\brief Value of m_size for sources that only compute the size once it is requested, see \ref compute_size
+		static constexpr uintptr_t unknown_size = ~uintptr_t{0};
+
+		///	\brief Called by \ref size the first time if m_size is unknown_size
+		virtual uintptr_t compute_size() const { return 0; }
+
+		mutable uintptr_t m_size = 0;
+	};
+
+	///	\brief A log message submitted as part of a batch
+	struct log_message_record
+	{
+		log_message_data data;
+		log_message_source const* message;
 	};
 } //namespace logger
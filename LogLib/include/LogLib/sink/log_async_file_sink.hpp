@@ -27,24 +27,48 @@
 
 #pragma once
 
+#include <cstdint>
 #include <filesystem>
 #include <vector>
-#include <queue>
+#include <memory>
 #include <atomic>
+#include <chrono>
+#include <string>
 
 #include <CoreLib/core_thread.hpp>
 #include <CoreLib/core_sync.hpp>
 #include <CoreLib/core_file.hpp>
 
 #include "log_sink.hpp"
+#include "log_flush_policy.hpp"
+#include "log_uring_writer.hpp"
+#include "log_direct_writer.hpp"
+#include "../log_clock.hpp"
 
 
 namespace logger
 {
+namespace _p
+{
+	class record_pool;
+}
+
 ///	\brief Created to do Logging to file
+///	\note Each thread logging to this sink gets its own lock-free buffer,
+///		the writer thread merges the buffers by order of submission.
+///		Records too large for the thread buffers are stored in buffers taken from a pool owned by the sink, records of 4GiB or more are discarded.
+///		The writer thread renders the records into a batch buffer, and writes the whole batch to the file at once.
+///		The conversion of the record timestamps to calendar time is done by the writer thread,
+///		the timestamps can be taken from the system clock or from raw ticks (see \ref set_clock_source).
+///		If enabled (see \ref set_repeat_suppression), consecutive records with the same site, level, and message are collapsed by the writer thread,
+///		a line stating how many times the record was repeated is written once a different record arrives or after a timeout.
 class log_async_file_sink final: public log_sink
 {
 public:
+	static constexpr uintptr_t default_thread_buffer_size = 0x40000;
+	static constexpr uintptr_t default_write_batch_size = 0x40000;
+	static constexpr std::chrono::milliseconds default_repeat_timeout{0};
+
 	log_async_file_sink();
 	~log_async_file_sink();
 
@@ -52,27 +76,137 @@ public:
 	///	\praram[in] - p_logData - Data that will be logged to the file
 	void output(log_data const& p_logData) final;
 
+	///	\brief Queues multiple records, the writer thread is only notified once
+	void output_batch(std::span<log_data const> p_records) final;
+
+	///	\brief Deferred messages are rendered on the writer thread
+	bool accepts_deferred() const final;
+
+	///	\brief Date and time are rendered by the writer thread, only captures the timestamp when using \ref log_clock_source::ticks
+	log_field required_fields() const final;
+
+	///	\brief Allocates the buffer of the calling thread
+	void prepare_thread() final;
+
 	///	\brief Initiates the logging to File stream,
 	///			Creates a file with the given file name
 	///	\param[in] - p_fileName - Name of the file that the message will be logged to
+	///	\param[in] - p_thread_buffer_size - Size in bytes of the buffer allocated for each thread that logs to this sink
 	///	\return true on success, false otherwise
-	bool init(std::filesystem::path const& p_fileName);
+	bool init(std::filesystem::path const& p_fileName, uintptr_t p_thread_buffer_size = default_thread_buffer_size);
+
+	///	\brief Sets the clock used to timestamp the records, \ref log_clock_source::ticks has less overhead on the logging threads
+	///		and orders the records of different threads with a higher resolution, but the conversion to calendar time is only an estimate.
+	///	\warning Must be called before \ref init, and before the sink is added to the logger
+	void set_clock_source(log_clock_source p_source);
+
+	///	\brief Sets when the data is flushed and synced to storage, the policy is executed by the writer thread
+	///	\warning Must be called before \ref init
+	void set_flush_policy(log_flush_policy const& p_policy);
+
+	///	\brief Writes through io_uring on Linux, the writer thread keeps gathering records while previous batches are being written
+	///	\warning Must be called before \ref init
+	void set_uring_backend(log_uring_config const& p_config);
+
+	///	\brief true if the file is being written through io_uring
+	bool uring_active() const;
+
+	///	\brief Writes bypassing the operating system cache, takes precedence over \ref set_uring_backend
+	///	\warning Must be called before \ref init
+	void set_direct_io(log_direct_config const& p_config);
+
+	///	\brief true if the file is being written with direct I/O
+	bool direct_active() const;
+
+	///	\brief Sets the amount of data the writer thread gathers before writing to the file,
+	///		records are also written once there are no more records to gather
+	///	\warning Must be called before \ref init
+	void set_write_batch_size(uintptr_t p_size);
+
+	///	\brief Sets how long repeated records can be held before their count is written
+	///	\param[in] - p_timeout - 0 (default) disables the suppression of repeated records
+	///	\warning Must be called before \ref init
+	void set_repeat_suppression(std::chrono::milliseconds p_timeout);
+
+	///	\brief Preallocates buffers for records larger than the thread buffers
+	///	\param[in] - p_record_size - Size in bytes of the records
+	///	\param[in] - p_count - Number of buffers to allocate
+	void reserve_large_records(uintptr_t p_record_size, uintptr_t p_count);
 
 	///	\brief Terminates the logging to File stream,
 	///			Closese the file which the message was logged to
+	///	\note Can be called while threads are still logging to the sink, it waits for them to finish the record being logged,
+	///		further records are discarded.
 	void end();
 
 private:
+	struct record_header;
+	struct thread_buffer;
+	class producer_scope;
+
+	thread_buffer& get_thread_buffer();
+	bool push_record(thread_buffer& p_buffer, log_data const& p_logData);
+	void wake_writer();
 	void run(void*);
-	void dispatch();
+	void refresh_buffers();
+	void reclaim_buffers();
+	bool has_pending() const;
+	bool dispatch();
+	void write_record(record_header const& p_header, char8_t const* p_data);
+	uintptr_t format_prefix(uint64_t p_stamp, char8_t* p_out);
+	uintptr_t format_repeats(char8_t* p_out);
+	void flush_repeats();
+	void batch_reserve(uintptr_t p_size);
+	void write_out(void const* p_data, uintptr_t p_size);
+	void flush_batch(bool p_urgent = false);
+	void apply_flush(_p::flush_control::action p_action);
+	std::chrono::steady_clock::time_point deadline() const;
+	void on_timer();
+	bool repeat_expired() const;
 
 	core::file_write m_file; //!< Output file
 
-	std::atomic<bool> m_quit = false;
+	std::atomic<bool> m_quit      = false;
+	std::atomic<bool> m_waiting   = false; //!< Writer thread is, or is about to be, waiting for data
+	std::atomic<bool> m_accepting = false; //!< Logging threads can use the thread buffers
+	std::atomic<uint32_t> m_producers = 0; //!< Logging threads using the thread buffers
 	core::thread m_thread;
 	core::event_trap m_trap;
-	core::atomic_spinlock m_lock;
-	std::queue<std::vector<char8_t>> m_data;
+
+	uint64_t  m_id = 0;                     //!< Unique per init, used to match threads to their buffers
+	uintptr_t m_thread_buffer_size = default_thread_buffer_size;
+
+	std::unique_ptr<_p::record_pool> const m_pool; //!< Buffers of records too large for the thread buffers
+
+	mutable core::atomic_spinlock m_lock;                 //!< Protects m_buffers
+	std::vector<std::shared_ptr<thread_buffer>> m_buffers; //!< Buffers of every thread that logged to this sink
+	std::atomic<uint64_t> m_generation = 0;                //!< Incremented every time m_buffers changes
+
+	//writer thread only
+	std::vector<thread_buffer*> m_readers;
+	uint64_t m_readers_generation = 0; //!< Value of m_generation when m_readers was built
+	std::vector<char8_t> m_batch;  //!< Records rendered and waiting to be written
+	uintptr_t m_batch_used = 0;
+	uintptr_t m_batch_size = default_write_batch_size;
+	uintptr_t m_prefix_size = 0;   //!< Size of the last [date-time prefix, records are rendered assuming the next one has the same size
+	log_clock_source m_clock_source = log_clock_source::system;
+	log_clock_calibration m_clock; //!< Converts the record timestamps to system time, only with log_clock_source::ticks
+
+	log_flush_policy m_policy;
+	_p::flush_control m_flush; //!< Writer thread only
+	_p::file_sync m_sync;
+
+	log_uring_config m_uring_config;
+	log_direct_config m_direct_config;
+	_p::uring_writer m_uring;   //!< Writer thread only
+	_p::direct_writer m_direct; //!< Writer thread only
+
+	//repeated records, writer thread only
+	std::chrono::milliseconds m_repeat_timeout = default_repeat_timeout;
+	std::u8string m_last_record;   //!< Last record written, without the date, time, and thread
+	uint64_t m_repeat_count = 0;   //!< Number of times the last record was repeated and not yet reported
+	uint64_t m_repeat_stamp = 0;   //!< Timestamp of the last repetition
+	std::chrono::steady_clock::time_point m_repeat_since; //!< When the first unreported repetition was found
 };
 
 }	// namespace logger
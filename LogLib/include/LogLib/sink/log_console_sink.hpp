@@ -38,6 +38,7 @@ class log_console_sink final: public log_sink
 public:
 	log_console_sink();
 	void output(log_data const& p_logData) final;
+	log_field required_fields() const final;
 };
 
 } // namespace logger
@@ -40,6 +40,7 @@ class log_debugger_sink final: public log_sink
 public:
 	log_debugger_sink();
 	void output(log_data const& p_logData) final;
+	log_field required_fields() const final;
 };
 } //namespace logger
 
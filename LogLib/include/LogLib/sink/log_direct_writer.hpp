@@ -0,0 +1,82 @@
+//======== ======== ======== ======== ======== ======== ======== ========
+///	\file
+///
+///	\copyright
+///		Copyright (c) Tiago Miguel Oliveira Freire
+///
+///		Permission is hereby granted, free of charge, to any person obtaining a copy
+///		of this software and associated documentation files (the "Software"),
+///		to copy, modify, publish, and/or distribute copies of the Software,
+///		and to permit persons to whom the Software is furnished to do so,
+///		subject to the following conditions:
+///
+///		The copyright notice and this permission notice shall be included in all
+///		copies or substantial portions of the Software.
+///		The copyrighted work, or derived works, shall not be used to train
+///		Artificial Intelligence models of any sort; or otherwise be used in a
+///		transformative way that could obfuscate the source of the copyright.
+///
+///		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+///		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+///		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+///		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+///		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+///		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+///		SOFTWARE.
+//======== ======== ======== ======== ======== ======== ======== ========
+
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+
+namespace logger
+{
+///	\brief Configures the direct I/O output backend of the file sinks (O_DIRECT, FILE_FLAG_NO_BUFFERING, or F_NOCACHE).
+///	\note Data bypasses the operating system cache, so that logging does not evict the cached data of the application.
+///		The data is gathered into aligned buffers, full buffers are written by a background thread while the next one is filled.
+///		The last partial block is only written when the sink is flushed or closed,
+///		until the file is closed the end of the file may contain zero padding.
+struct log_direct_config
+{
+	uint32_t  buffer_count = 0;        //!< Number of buffers alternating between filling and writing, 0 disables the backend, at least 2 are used
+	uintptr_t buffer_size  = 0x100000; //!< Size in bytes of each buffer, rounded up to the alignment
+	uintptr_t alignment    = 0;        //!< Alignment in bytes required by the device for direct I/O, 0 queries the file system
+};
+
+namespace _p
+{
+	///	\brief Writes sequentially to a file bypassing the operating system cache, uses its own handle to the file
+	///	\warning Not thread safe
+	class direct_writer
+	{
+	public:
+		direct_writer();
+		direct_writer(direct_writer const&) = delete;
+		direct_writer& operator = (direct_writer const&) = delete;
+		~direct_writer();
+
+		///	\brief Opens the file for writing, data is appended after its current end
+		///	\return false if the file could not be opened, or the file system does not support direct I/O
+		bool open(std::filesystem::path const& p_fileName, log_direct_config const& p_config);
+
+		///	\brief Writes the pending data, and trims the padding from the end of the file
+		void close();
+
+		inline bool is_open() const { return m_file != nullptr; }
+
+		///	\brief Copies the data into the buffers, full buffers are handed to the background thread
+		void write(void const* p_data, uintptr_t p_size);
+
+		///	\brief Waits until all data has been written, including the last partial block
+		void flush();
+
+	private:
+		struct file;
+		std::unique_ptr<file> m_file;
+	};
+} //namespace _p
+
+}	// namespace logger
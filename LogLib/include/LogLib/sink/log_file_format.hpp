@@ -0,0 +1,110 @@
+//======== ======== ======== ======== ======== ======== ======== ========
+///	\file
+///
+///	\copyright
+///		Copyright (c) Tiago Miguel Oliveira Freire
+///
+///		Permission is hereby granted, free of charge, to any person obtaining a copy
+///		of this software and associated documentation files (the "Software"),
+///		to copy, modify, publish, and/or distribute copies of the Software,
+///		and to permit persons to whom the Software is furnished to do so,
+///		subject to the following conditions:
+///
+///		The copyright notice and this permission notice shall be included in all
+///		copies or substantial portions of the Software.
+///		The copyrighted work, or derived works, shall not be used to train
+///		Artificial Intelligence models of any sort; or otherwise be used in a
+///		transformative way that could obfuscate the source of the copyright.
+///
+///		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+///		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+///		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+///		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+///		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+///		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+///		SOFTWARE.
+//======== ======== ======== ======== ======== ======== ======== ========
+
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#include <CoreLib/string/core_string_encoding.hpp>
+
+#include "log_sink.hpp"
+
+namespace logger::_p
+{
+	//[date-time|thread]File(Line,Column) Level: Message\n
+	//shared by the sinks that write text files
+
+	inline void file_record_transfer(char8_t*& p_buff, std::u8string_view const p_str)
+	{
+		memcpy(p_buff, p_str.data(), p_str.size());
+		p_buff += p_str.size();
+	}
+
+	inline uintptr_t file_record_name_size(log_data const& p_logData)
+	{
+#ifdef _WIN32
+		return core::UTF16_to_UTF8_faulty_size(std::u16string_view{reinterpret_cast<char16_t const*>(p_logData.file.data()), p_logData.file.size()}, '?');
+#else
+		return p_logData.file.size();
+#endif
+	}
+
+	inline uintptr_t file_record_size(log_data const& p_logData, uintptr_t const p_fileName_size)
+	{
+		return
+			p_logData.sv_date.size()
+			+ p_logData.sv_time.size()
+			+ p_logData.sv_thread.size()
+			+ p_fileName_size
+			+ p_logData.sv_line.size()
+			+ (p_logData.column ? p_logData.sv_column.size() + 1 : 0) //,
+			+ p_logData.sv_level.size()
+			+ p_logData.message_source->size() + 10; //[-|]() : \n
+	}
+
+	///	\brief Renders the record into p_out, which must have at least \ref file_record_size bytes
+	///	\return End of the rendered record
+	inline char8_t* file_record_write(log_data const& p_logData, char8_t* pivot, [[maybe_unused]] uintptr_t const p_fileName_size)
+	{
+		*(pivot++) = u8'[';
+		file_record_transfer(pivot, p_logData.sv_date);
+		*(pivot++) = u8'-';
+		file_record_transfer(pivot, p_logData.sv_time);
+		*(pivot++) = u8'|';
+		file_record_transfer(pivot, p_logData.sv_thread);
+		*(pivot++) = u8']';
+
+#ifdef _WIN32
+		core::UTF16_to_UTF8_faulty_unsafe(std::u16string_view{reinterpret_cast<char16_t const*>(p_logData.file.data()), p_logData.file.size()}, '?', pivot);
+		pivot += p_fileName_size;
+#else
+		memcpy(pivot, p_logData.file.data(), p_logData.file.size());
+		pivot += p_logData.file.size();
+#endif
+
+		*(pivot++) = u8'(';
+		file_record_transfer(pivot, p_logData.sv_line);
+
+		if(p_logData.column)
+		{
+			*(pivot++) = u8',';
+			file_record_transfer(pivot, p_logData.sv_column);
+		}
+		*(pivot++) = u8')';
+		*(pivot++) = u8' ';
+		file_record_transfer(pivot, p_logData.sv_level);
+		*(pivot++) = u8':';
+		*(pivot++) = u8' ';
+		p_logData.message_source->render(pivot);
+		pivot += p_logData.message_source->size();
+		*(pivot++) = u8'\n';
+		return pivot;
+	}
+} //namespace logger::_p
@@ -28,14 +28,20 @@
 #pragma once
 
 #include <filesystem>
+#include <mutex>
 
 #include <CoreLib/core_file.hpp>
+#include <CoreLib/core_sync.hpp>
 
 #include "log_sink.hpp"
+#include "log_flush_policy.hpp"
+#include "log_uring_writer.hpp"
+#include "log_direct_writer.hpp"
 
 namespace logger
 {
 ///	\brief Created to do Logging to file
+///	\note The time based flush policies are only checked when records are written (see \ref log_flush_policy)
 class log_file_sink final: public log_sink
 {
 public:
@@ -46,18 +52,55 @@ public:
 	///	\praram[in] - p_logData - Data that will be logged to the file
 	void output(log_data const& p_logData) final;
 
+	///	\brief Logs multiple records to file with a single write
+	void output_batch(std::span<log_data const> p_records) final;
+
+	log_field required_fields() const final;
+
 	///	\brief Initiates the logging to File stream,
 	///			Creates a file with the given file name
 	///	\param[in] - p_fileName - Name of the file that the message will be logged to
 	///	\return true on success, false otherwise
 	bool init(std::filesystem::path const& p_fileName);
 
+	///	\brief Sets when the data is flushed and synced to storage
+	///	\warning Must be called before \ref init
+	void set_flush_policy(log_flush_policy const& p_policy);
+
+	///	\brief Writes through io_uring on Linux, the logging threads no longer wait for the writes to complete
+	///	\warning Must be called before \ref init
+	void set_uring_backend(log_uring_config const& p_config);
+
+	///	\brief true if the file is being written through io_uring
+	bool uring_active() const;
+
+	///	\brief Writes bypassing the operating system cache, takes precedence over \ref set_uring_backend
+	///	\warning Must be called before \ref init
+	void set_direct_io(log_direct_config const& p_config);
+
+	///	\brief true if the file is being written with direct I/O
+	bool direct_active() const;
+
 	///	\brief Terminates the logging to File stream,
 	///			Closese the file which the message was logged to
 	void end();
 
 private:
+	void write_out(void const* p_data, uintptr_t p_size);
+	void written(uintptr_t p_bytes, bool p_urgent);
+
 	core::file_write m_file; //!< Output file
+
+	log_flush_policy m_policy;
+	core::atomic_spinlock m_flush_lock; //!< Protects m_flush
+	_p::flush_control m_flush;
+	_p::file_sync m_sync;
+
+	log_uring_config m_uring_config;
+	log_direct_config m_direct_config;
+	std::mutex m_backend_lock; //!< Protects m_uring and m_direct
+	_p::uring_writer m_uring;
+	_p::direct_writer m_direct;
 };
 
 }	// namespace logger
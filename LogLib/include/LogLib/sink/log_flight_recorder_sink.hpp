@@ -0,0 +1,84 @@
+//======== ======== ======== ======== ======== ======== ======== ========
+///	\file
+///
+///	\copyright
+///		Copyright (c) Tiago Miguel Oliveira Freire
+///
+///		Permission is hereby granted, free of charge, to any person obtaining a copy
+///		of this software and associated documentation files (the "Software"),
+///		to copy, modify, publish, and/or distribute copies of the Software,
+///		and to permit persons to whom the Software is furnished to do so,
+///		subject to the following conditions:
+///
+///		The copyright notice and this permission notice shall be included in all
+///		copies or substantial portions of the Software.
+///		The copyrighted work, or derived works, shall not be used to train
+///		Artificial Intelligence models of any sort; or otherwise be used in a
+///		transformative way that could obfuscate the source of the copyright.
+///
+///		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+///		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+///		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+///		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+///		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+///		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+///		SOFTWARE.
+//======== ======== ======== ======== ======== ======== ======== ========
+
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+
+#include "log_sink.hpp"
+
+namespace logger
+{
+///	\brief Logs into a ring of records kept in a memory mapped file, that survives a crash of the process.
+///	\note The records are rendered directly into the mapping and marked complete once written, no system call is made per record.
+///		Once the ring is full the oldest records are overwritten.
+///		After a crash the records can be read with \ref read_flight_recorder (see log_flight_recorder.hpp), or the LogRecover tool.
+///		Records larger than half of the ring are truncated.
+///	\warning The data is only safe from a crash of the process, not from a crash of the operating system.
+///		\ref init overwrites the file, records from a previous run must be recovered before that.
+class log_flight_recorder_sink final: public log_sink
+{
+public:
+	static constexpr uintptr_t default_ring_size = 0x1000000;
+
+	log_flight_recorder_sink();
+	~log_flight_recorder_sink();
+
+	///	\brief Logs data to the ring
+	///	\praram[in] - p_logData - Data that will be logged
+	void output(log_data const& p_logData) final;
+
+	log_field required_fields() const final;
+
+	///	\brief Creates the file and maps it
+	///	\param[in] - p_fileName - Name of the file that holds the ring
+	///	\param[in] - p_ring_size - Size in bytes of the ring, rounded up to 4KiB
+	///	\return true on success, false otherwise
+	bool init(std::filesystem::path const& p_fileName, uintptr_t p_ring_size = default_ring_size);
+
+	///	\brief Unmaps and closes the file, the records are kept
+	void end();
+
+private:
+	void copy(uint64_t p_position, char8_t const* p_data, uintptr_t p_size);
+
+#ifdef _WIN32
+	void* m_file    = nullptr;
+	void* m_mapping = nullptr;
+#else
+	int m_file = -1;
+#endif
+	void*     m_view = nullptr;
+	uintptr_t m_view_size = 0;
+	char8_t*  m_ring = nullptr;
+	uint64_t* m_head = nullptr; //!< Inside the mapping
+	uintptr_t m_ring_size = 0;
+};
+
+}	// namespace logger
@@ -0,0 +1,108 @@
+//======== ======== ======== ======== ======== ======== ======== ========
+///	\file
+///
+///	\copyright
+///		Copyright (c) Tiago Miguel Oliveira Freire
+///
+///		Permission is hereby granted, free of charge, to any person obtaining a copy
+///		of this software and associated documentation files (the "Software"),
+///		to copy, modify, publish, and/or distribute copies of the Software,
+///		and to permit persons to whom the Software is furnished to do so,
+///		subject to the following conditions:
+///
+///		The copyright notice and this permission notice shall be included in all
+///		copies or substantial portions of the Software.
+///		The copyrighted work, or derived works, shall not be used to train
+///		Artificial Intelligence models of any sort; or otherwise be used in a
+///		transformative way that could obfuscate the source of the copyright.
+///
+///		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+///		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+///		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+///		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+///		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+///		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+///		SOFTWARE.
+//======== ======== ======== ======== ======== ======== ======== ========
+
+
+#pragma once
+
+#include <cstdint>
+#include <chrono>
+#include <filesystem>
+
+namespace logger
+{
+///	\brief Decides when a file sink flushes its data to the operating system, and when it makes it durable on storage.
+///	\note By default data is only flushed when the sink is closed.
+struct log_flush_policy
+{
+	uintptr_t flush_bytes = 0;                   //!< Flush once this many bytes have been written since the last flush, 0 disables
+	std::chrono::milliseconds flush_interval{0}; //!< Flush data that has been waiting for this long, 0 disables
+	bool flush_on_error = false;                 //!< Flush (and sync, if enabled) as soon as a record with Level::Error is written
+	std::chrono::milliseconds sync_interval{0};  //!< Makes the written data durable (fdatasync / FlushFileBuffers) at most this often, 0 leaves it to the operating system
+};
+
+namespace _p
+{
+	///	\brief Book keeping of a \ref log_flush_policy, does not perform the flush itself
+	class flush_control
+	{
+	public:
+		using clock = std::chrono::steady_clock;
+
+		enum class action: uint8_t
+		{
+			none,
+			flush,
+			sync, //!< Flush and sync
+		};
+
+		void init(log_flush_policy const& p_policy);
+
+		inline log_flush_policy const& policy() const { return m_policy; }
+
+		///	\brief Accounts for data written to the file
+		///	\param[in] p_urgent - The data contains an error record
+		[[nodiscard]] action on_write(uintptr_t p_bytes, bool p_urgent, clock::time_point p_now);
+
+		///	\brief Checks the time based policies, for when no data is being written
+		[[nodiscard]] action on_timer(clock::time_point p_now);
+
+		///	\brief Next time \ref on_timer has something to do, time_point::max() if nothing is pending
+		[[nodiscard]] clock::time_point deadline() const;
+
+	private:
+		action take_flush(bool p_urgent, clock::time_point p_now);
+
+		log_flush_policy m_policy;
+		uintptr_t m_unflushed = 0;
+		bool m_unsynced = false;
+		clock::time_point m_unflushed_since;
+		clock::time_point m_last_sync;
+	};
+
+	///	\brief Makes the data of a file durable on storage, uses its own handle to the file
+	class file_sync
+	{
+	public:
+		file_sync() = default;
+		file_sync(file_sync const&) = delete;
+		file_sync& operator = (file_sync const&) = delete;
+		~file_sync();
+
+		bool open(std::filesystem::path const& p_fileName);
+		void close();
+		void sync();
+
+	private:
+#ifdef _WIN32
+		void* m_handle = nullptr;
+#else
+		int m_handle = -1;
+#endif
+	};
+} //namespace _p
+
+}	// namespace logger
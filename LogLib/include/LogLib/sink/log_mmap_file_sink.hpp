@@ -0,0 +1,113 @@
+//======== ======== ======== ======== ======== ======== ======== ========
+///	\file
+///
+///	\copyright
+///		Copyright (c) Tiago Miguel Oliveira Freire
+///
+///		Permission is hereby granted, free of charge, to any person obtaining a copy
+///		of this software and associated documentation files (the "Software"),
+///		to copy, modify, publish, and/or distribute copies of the Software,
+///		and to permit persons to whom the Software is furnished to do so,
+///		subject to the following conditions:
+///
+///		The copyright notice and this permission notice shall be included in all
+///		copies or substantial portions of the Software.
+///		The copyrighted work, or derived works, shall not be used to train
+///		Artificial Intelligence models of any sort; or otherwise be used in a
+///		transformative way that could obfuscate the source of the copyright.
+///
+///		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+///		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+///		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+///		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+///		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+///		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+///		SOFTWARE.
+//======== ======== ======== ======== ======== ======== ======== ========
+
+
+#pragma once
+
+#include <cstdint>
+#include <array>
+#include <atomic>
+#include <filesystem>
+
+#include <CoreLib/core_thread.hpp>
+#include <CoreLib/core_sync.hpp>
+
+#include "log_sink.hpp"
+
+namespace logger
+{
+///	\brief Logs to a memory mapped file
+///	\note The file is grown and mapped in chunks by a background thread, ahead of the records.
+///		Logging threads reserve their space in the file with an atomic offset and render the records directly into the mapping,
+///		no system call is made per record. Records are written in the order their space was reserved.
+///		Data copied into the mapping survives a crash of the process, the file is then left with the unused part of the last chunk zero filled.
+///		The file is truncated to the size of the data in \ref end.
+class log_mmap_file_sink final: public log_sink
+{
+public:
+	static constexpr uintptr_t default_chunk_size = 0x4000000;
+
+	log_mmap_file_sink();
+	~log_mmap_file_sink();
+
+	///	\brief Logs data to file
+	///	\praram[in] - p_logData - Data that will be logged to the file
+	void output(log_data const& p_logData) final;
+
+	///	\brief Reserves the space for all the records at once
+	void output_batch(std::span<log_data const> p_records) final;
+
+	log_field required_fields() const final;
+
+	///	\brief Initiates the logging to File stream,
+	///			Creates a file with the given file name
+	///	\param[in] - p_fileName - Name of the file that the message will be logged to
+	///	\param[in] - p_chunk_size - Size in bytes by which the file is grown and mapped, rounded up to 64KiB
+	///	\return true on success, false otherwise
+	bool init(std::filesystem::path const& p_fileName, uintptr_t p_chunk_size = default_chunk_size);
+
+	///	\brief Terminates the logging to File stream,
+	///			Truncates the file to the size of the data and closes it
+	void end();
+
+private:
+	static constexpr uint32_t chunk_slots = 4; //!< Chunks that can be mapped at the same time
+
+	struct chunk
+	{
+		std::atomic<uint64_t> ready     = 0; //!< Index + 1 of the chunk mapped in this slot, 0 if none
+		std::atomic<uint64_t> committed = 0; //!< Bytes of the chunk already written
+		char8_t* data = nullptr;
+	};
+
+	char8_t* get_chunk(uint64_t p_index);
+	void commit(uint64_t p_index, uintptr_t p_size);
+	void copy(uint64_t p_offset, char8_t const* p_data, uintptr_t p_size);
+	void run(void*);
+	bool map_chunk(uint64_t p_index, chunk& p_chunk);
+	void unmap_chunk(chunk& p_chunk);
+
+#ifdef _WIN32
+	void* m_file = nullptr;
+#else
+	int m_file = -1;
+#endif
+
+	uintptr_t m_chunk_size = default_chunk_size;
+	std::atomic<uint64_t> m_offset = 0; //!< Position in the file of the next record
+	std::atomic<uint64_t> m_wanted = 0; //!< Highest chunk requested by the logging threads
+	std::atomic<bool> m_failed = false; //!< The file could not be grown, records are dropped
+	std::atomic<bool> m_quit   = false;
+	std::array<chunk, chunk_slots> m_chunks;
+
+	//background thread only
+	uint64_t m_next_chunk = 0; //!< Next chunk to be mapped
+	core::thread m_thread;
+	core::event_trap m_trap;
+};
+
+}	// namespace logger
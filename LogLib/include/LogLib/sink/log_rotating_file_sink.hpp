@@ -0,0 +1,137 @@
+//======== ======== ======== ======== ======== ======== ======== ========
+///	\file
+///
+///	\copyright
+///		Copyright (c) Tiago Miguel Oliveira Freire
+///
+///		Permission is hereby granted, free of charge, to any person obtaining a copy
+///		of this software and associated documentation files (the "Software"),
+///		to copy, modify, publish, and/or distribute copies of the Software,
+///		and to permit persons to whom the Software is furnished to do so,
+///		subject to the following conditions:
+///
+///		The copyright notice and this permission notice shall be included in all
+///		copies or substantial portions of the Software.
+///		The copyrighted work, or derived works, shall not be used to train
+///		Artificial Intelligence models of any sort; or otherwise be used in a
+///		transformative way that could obfuscate the source of the copyright.
+///
+///		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+///		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+///		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+///		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+///		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+///		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+///		SOFTWARE.
+//======== ======== ======== ======== ======== ======== ======== ========
+
+
+#pragma once
+
+#include <cstdint>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <filesystem>
+
+#include <CoreLib/core_file.hpp>
+#include <CoreLib/core_thread.hpp>
+#include <CoreLib/core_sync.hpp>
+
+#include "log_sink.hpp"
+
+namespace logger
+{
+///	\brief Decides when \ref log_rotating_file_sink switches to a new file, and how many old files are kept
+struct log_rotation_policy
+{
+	uint64_t max_size = 0;            //!< Rotates once the file reaches this size in bytes, 0 disables
+	std::chrono::seconds interval{0}; //!< Rotates at every multiple of the interval since the epoch (UTC), ex. 24h rotates at midnight UTC, 0 disables
+	uint32_t retention = 0;           //!< Number of closed files kept, the oldest ones are removed, 0 keeps all
+};
+
+///	\brief Processes the files closed by \ref log_rotating_file_sink on its background thread
+class log_segment_compressor
+{
+public:
+	virtual ~log_segment_compressor() = default;
+
+	///	\brief Compresses a closed file
+	///	\return Path of the compressed file, the sink then removes the original.
+	///		An empty path (or p_segment) keeps the original file.
+	virtual std::filesystem::path compress(std::filesystem::path const& p_segment) = 0;
+};
+
+///	\brief Logs to a sequence of files, named <stem>.<number><extension> after the name given to \ref init
+///	\note The next file is opened ahead of time by a background thread, the logging threads switch files with a single atomic operation.
+///		If the next file is not ready yet, the logging threads keep writing to the current file instead of waiting.
+///		The closed files are compressed (see \ref set_compressor) and removed (see \ref log_rotation_policy::retention) by the background thread.
+class log_rotating_file_sink final: public log_sink
+{
+public:
+	log_rotating_file_sink();
+	~log_rotating_file_sink();
+
+	///	\brief Logs data to file
+	///	\praram[in] - p_logData - Data that will be logged to the file
+	void output(log_data const& p_logData) final;
+
+	///	\brief Logs multiple records to file with a single write
+	void output_batch(std::span<log_data const> p_records) final;
+
+	log_field required_fields() const final;
+
+	///	\brief Sets when the files are rotated
+	///	\warning Must be called before \ref init
+	void set_rotation_policy(log_rotation_policy const& p_policy);
+
+	///	\brief Sets how the closed files are compressed, nullptr (default) leaves them uncompressed
+	///	\warning Must be called before \ref init, the compressor must outlive the sink
+	void set_compressor(log_segment_compressor* p_compressor);
+
+	///	\brief Initiates the logging to File stream.
+	///		The numbering continues after the files left by previous runs, which also count towards the retention
+	///	\param[in] - p_fileName - Name from which the names of the files are derived, ex. "dir/app.log" logs to "dir/app.000001.log", "dir/app.000002.log", ...
+	///	\return true on success, false otherwise
+	bool init(std::filesystem::path const& p_fileName);
+
+	///	\brief Terminates the logging to File stream,
+	///			Closes the current file
+	void end();
+
+private:
+	struct segment
+	{
+		core::file_write file;
+		std::filesystem::path path;
+		std::atomic<uint32_t> users = 0; //!< Logging threads writing to the file
+		std::atomic<uint64_t> size  = 0;
+	};
+
+	void write(void const* p_data, uintptr_t p_size);
+	void try_rotate(uint64_t p_generation);
+	bool open_segment(segment& p_segment);
+	void close_segment(std::filesystem::path const& p_path);
+	void run(void*);
+
+	log_rotation_policy m_policy;
+	log_segment_compressor* m_compressor = nullptr;
+
+	std::array<segment, 2> m_segments;
+	std::atomic<uint64_t> m_generation = 0;     //!< Incremented every time a segment takes over, the segment being written is m_segments[m_generation & 1]
+	std::atomic<bool>     m_ready      = false; //!< The other segment is open and can take over
+	std::atomic<bool>     m_retiring   = false; //!< The other segment was replaced and must be closed
+	std::atomic<bool>     m_quit       = false;
+
+	//background thread only
+	std::filesystem::path m_directory;
+	std::filesystem::path m_stem;
+	std::filesystem::path m_extension;
+	uint64_t m_sequence = 0;                  //!< Number of the next file
+	std::deque<std::filesystem::path> m_closed; //!< Closed files, oldest first
+	core::thread m_thread;
+	core::event_trap m_trap;
+};
+
+}	// namespace logger
@@ -28,6 +28,8 @@
 #pragma once
 
 #include <cstdint>
+#include <cstddef>
+#include <span>
 #include <string_view>
 
 #include <CoreLib/core_time.hpp>
@@ -38,6 +40,48 @@
 
 namespace logger
 {
+///	\brief Derived fields of \ref log_data that a sink may require the logger to render
+enum class log_field: uint8_t
+{
+	none	= 0x00,
+	level	= 0x01, //!< log_data::sv_level
+	date	= 0x02, //!< log_data::sv_date and log_data::time_struct
+	time	= 0x04, //!< log_data::sv_time and log_data::time_struct
+	thread	= 0x08, //!< log_data::sv_thread
+	line	= 0x10, //!< log_data::sv_line
+	column	= 0x20, //!< log_data::sv_column
+	timestamp	= 0x40, //!< log_data::timestamp
+	message	= 0x80, //!< log_data::message, sinks can otherwise render it themselves from log_data::message_source
+	all		= 0xFF,
+};
+
+constexpr log_field operator | (log_field const p_1, log_field const p_2)
+{
+	return static_cast<log_field>(static_cast<uint8_t>(p_1) | static_cast<uint8_t>(p_2));
+}
+
+constexpr log_field operator & (log_field const p_1, log_field const p_2)
+{
+	return static_cast<log_field>(static_cast<uint8_t>(p_1) & static_cast<uint8_t>(p_2));
+}
+
+constexpr log_field& operator |= (log_field& p_1, log_field const p_2)
+{
+	return p_1 = p_1 | p_2;
+}
+
+constexpr bool has_field(log_field const p_fields, log_field const p_test)
+{
+	return (p_fields & p_test) != log_field::none;
+}
+
+///	\brief Per sink restrictions, evaluated by the logger before the sink is called
+struct log_sink_filter
+{
+	Level min_level = Level::Trace;		//!< Lowest level forwarded to the sink (see \ref level_rank)
+	void const* module_base = nullptr;	//!< If not nullptr, only logs generated by this module are forwarded to the sink
+};
+
 ///	\brief Holds the Logging data information
 struct log_data: public log_message_data
 {
@@ -48,15 +92,26 @@ struct log_data: public log_message_data
 	}
 
 	core::thread_id_t		thread_id;
-	core::date_time_t		time_struct;
+	core::date_time_t		time_struct;	//!< Only set if a sink requires \ref log_field::date or \ref log_field::time
+	uint64_t				timestamp;		//!< Raw ticks (see \ref log_clock_ticks), only set if a sink requires \ref log_field::timestamp
+
+	//the following are empty if no sink in the group requires them (see \ref log_sink::required_fields)
 
-	std::u8string_view		message;
+	std::u8string_view		message;		//!< Only set if a sink requires \ref log_field::message
 	std::u8string_view		sv_line;
 	std::u8string_view		sv_column;
 	std::u8string_view		sv_date;
 	std::u8string_view		sv_time;
 	std::u8string_view		sv_thread;
 	std::u8string_view		sv_level;
+
+	///	\brief Raw arguments of a deferred log (see \ref log_deferred.hpp), data() is nullptr if the log was not deferred.
+	///	\note Only relevant for sinks that return true on \ref log_sink::accepts_deferred, if set the message
+	///		may not have been rendered and those sinks are expected to use \ref deferred_format instead.
+	std::span<std::byte const>	deferred_message;
+
+	///	\brief Always set, allows the sink to render the message directly into its own memory (ex. a ring buffer or a write buffer)
+	log_message_source const*	message_source;
 };
 
 ///	\brief Created to do Logging streams
@@ -64,6 +119,28 @@ class log_sink
 {
 public:
 	virtual void output(log_data const& p_logData) = 0;
+
+	///	\brief Receives multiple records at once, allows the sink to amortize its per call costs (ex. system calls or locks).
+	///		By default forwards each record to \ref output.
+	virtual void output_batch(std::span<log_data const> const p_records)
+	{
+		for(log_data const& record: p_records)
+		{
+			output(record);
+		}
+	}
+
+	///	\brief If true the sink is able to render deferred messages by itself (ex. on a separate thread),
+	///		allowing the logger to skip formatting the message on the calling thread.
+	virtual bool accepts_deferred() const { return false; }
+
+	///	\brief Fields of \ref log_data that the sink uses, the logger skips rendering the fields no sink requires.
+	///	\note Queried only once when the sink is added to the logger, the result is not expected to change.
+	virtual log_field required_fields() const { return log_field::all; }
+
+	///	\brief Called on a thread that will log to this sink, allows the sink to allocate
+	///		its per thread resources ahead of time (ex. before entering a section where allocations are forbidden).
+	virtual void prepare_thread() {}
 };
 
 }	// namespace simLog
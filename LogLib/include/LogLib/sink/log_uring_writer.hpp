@@ -0,0 +1,84 @@
+//======== ======== ======== ======== ======== ======== ======== ========
+///	\file
+///
+///	\copyright
+///		Copyright (c) Tiago Miguel Oliveira Freire
+///
+///		Permission is hereby granted, free of charge, to any person obtaining a copy
+///		of this software and associated documentation files (the "Software"),
+///		to copy, modify, publish, and/or distribute copies of the Software,
+///		and to permit persons to whom the Software is furnished to do so,
+///		subject to the following conditions:
+///
+///		The copyright notice and this permission notice shall be included in all
+///		copies or substantial portions of the Software.
+///		The copyrighted work, or derived works, shall not be used to train
+///		Artificial Intelligence models of any sort; or otherwise be used in a
+///		transformative way that could obfuscate the source of the copyright.
+///
+///		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+///		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+///		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+///		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+///		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+///		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+///		SOFTWARE.
+//======== ======== ======== ======== ======== ======== ======== ========
+
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+
+namespace logger
+{
+///	\brief Configures the io_uring output backend of the file sinks (Linux only).
+///	\note Data is gathered into registered buffers, a buffer is submitted once it is full (or on flush) without waiting for the write to complete,
+///		the writer only blocks when all buffers are in flight.
+///		If io_uring is not available (ex. older kernels, or blocked by a seccomp profile), or stops working, the sink writes synchronously.
+struct log_uring_config
+{
+	uint32_t  buffer_count = 0;       //!< Maximum number of writes in flight, 0 disables the backend
+	uintptr_t buffer_size  = 0x40000; //!< Size in bytes of each registered buffer
+};
+
+namespace _p
+{
+	///	\brief Writes sequentially to a file through io_uring, uses its own handle to the file
+	///	\warning Not thread safe
+	class uring_writer
+	{
+	public:
+		uring_writer();
+		uring_writer(uring_writer const&) = delete;
+		uring_writer& operator = (uring_writer const&) = delete;
+		~uring_writer();
+
+		///	\brief Opens the file for writing, data is appended after its current end
+		///	\return false if io_uring is not available or the file could not be opened
+		bool open(std::filesystem::path const& p_fileName, log_uring_config const& p_config);
+
+		///	\brief Waits for the data in flight and closes the file
+		void close();
+
+		inline bool is_open() const { return m_ring != nullptr; }
+
+		///	\brief true if io_uring stopped working, the data pending at the time and any further data are written synchronously
+		///	\note Can be called from any thread
+		bool failed() const;
+
+		///	\brief Appends the data to the current buffer, full buffers are submitted
+		void write(void const* p_data, uintptr_t p_size);
+
+		///	\brief Submits the partially filled buffer, and waits until all the data has been written
+		void wait_all();
+
+	private:
+		struct ring;
+		std::unique_ptr<ring> m_ring;
+	};
+} //namespace _p
+
+}	// namespace logger
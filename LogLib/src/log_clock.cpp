@@ -0,0 +1,219 @@
+//======== ======== ======== ======== ======== ======== ======== ========
+///	\file
+///
+///	\copyright
+///		Copyright (c) Tiago Miguel Oliveira Freire
+///
+///		Permission is hereby granted, free of charge, to any person obtaining a copy
+///		of this software and associated documentation files (the "Software"),
+///		to copy, modify, publish, and/or distribute copies of the Software,
+///		and to permit persons to whom the Software is furnished to do so,
+///		subject to the following conditions:
+///
+///		The copyright notice and this permission notice shall be included in all
+///		copies or substantial portions of the Software.
+///		The copyrighted work, or derived works, shall not be used to train
+///		Artificial Intelligence models of any sort; or otherwise be used in a
+///		transformative way that could obfuscate the source of the copyright.
+///
+///		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+///		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+///		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+///		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+///		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+///		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+///		SOFTWARE.
+//======== ======== ======== ======== ======== ======== ======== ========
+
+
+#include <LogLib/log_clock.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+
+#include <CoreLib/string/core_string_numeric.hpp>
+
+namespace logger
+{
+
+static int64_t system_now()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+void log_clock_calibration::calibrate()
+{
+	//a short busy wait is enough to get a first estimate, refresh improves it over longer periods
+	constexpr std::chrono::milliseconds calibration_period{10};
+
+	std::chrono::steady_clock::time_point const start = std::chrono::steady_clock::now();
+	uint64_t const start_ticks = log_clock_ticks();
+
+	std::chrono::steady_clock::time_point end;
+	do
+	{
+		end = std::chrono::steady_clock::now();
+	}
+	while(end - start < calibration_period);
+
+	uint64_t const end_ticks = log_clock_ticks();
+	std::chrono::steady_clock::time_point const end_check = std::chrono::steady_clock::now();
+
+	uint64_t const elapsed_ticks = end_ticks > start_ticks ? end_ticks - start_ticks : 1;
+	double const elapsed_ns = std::chrono::duration<double, std::nano>((end - start) + (end_check - end) / 2).count();
+
+	m_ns_per_tick   = elapsed_ns / static_cast<double>(elapsed_ticks);
+	m_rate          = m_ns_per_tick;
+	m_refresh_ticks = static_cast<uint64_t>(1e9 / m_ns_per_tick);
+
+	//the system clock is only used as the anchor
+	m_steady_anchor = std::chrono::steady_clock::now();
+	m_tick_anchor   = log_clock_ticks();
+	m_time_anchor   = system_now();
+}
+
+void log_clock_calibration::refresh()
+{
+	uint64_t const ticks = log_clock_ticks();
+	if(ticks - m_tick_anchor < m_refresh_ticks)
+	{
+		return;
+	}
+
+	std::chrono::steady_clock::time_point const steady = std::chrono::steady_clock::now();
+	int64_t const time = system_now();
+
+	m_ns_per_tick = std::chrono::duration<double, std::nano>(steady - m_steady_anchor).count() / static_cast<double>(ticks - m_tick_anchor);
+
+	//the new anchor continues the current conversion,
+	//the error against the system clock is corrected over the next period by adjusting the rate
+	int64_t const predicted = to_system_time(ticks).time_since_epoch().count();
+	double const error  = static_cast<double>(time - predicted);
+	double const period = m_ns_per_tick * static_cast<double>(m_refresh_ticks);
+
+	if(error > period)
+	{
+		//forward steps of the system clock are followed immediately
+		m_time_anchor = time;
+		m_rate = m_ns_per_tick;
+	}
+	else
+	{
+		//at most half the rate is removed, so the conversion never goes backwards
+		m_time_anchor = predicted;
+		m_rate = m_ns_per_tick * (1.0 + std::max(error, -period / 2) / period);
+	}
+	m_tick_anchor   = ticks;
+	m_steady_anchor = steady;
+}
+
+log_system_time log_clock_calibration::to_system_time(uint64_t const p_ticks) const
+{
+	//records may have been captured before the last refresh
+	int64_t const delta = static_cast<int64_t>(p_ticks - m_tick_anchor);
+	return log_system_time{std::chrono::nanoseconds{m_time_anchor + std::llround(static_cast<double>(delta) * m_rate)}};
+}
+
+core::date_time_t log_date_time(log_system_time const p_time)
+{
+	std::chrono::sys_days const day = std::chrono::floor<std::chrono::days>(p_time);
+	std::chrono::year_month_day const date{day};
+	std::chrono::hh_mm_ss<std::chrono::nanoseconds> const time{p_time - day};
+
+	core::date_time_t out;
+	out.date.year    = static_cast<uint16_t>(static_cast<int>(date.year()));
+	out.date.month   = static_cast<uint8_t>(static_cast<unsigned>(date.month()));
+	out.date.day     = static_cast<uint8_t>(static_cast<unsigned>(date.day()));
+	out.time.hour    = static_cast<uint8_t>(time.hours().count());
+	out.time.minute  = static_cast<uint8_t>(time.minutes().count());
+	out.time.second  = static_cast<uint8_t>(time.seconds().count());
+	out.time.nsecond = static_cast<uint32_t>(time.subseconds().count());
+	return out;
+}
+
+uintptr_t format_log_date(core::date_time_t const& p_time, std::span<char8_t, log_date_max_size> const p_out)
+{
+	char8_t* pivot = p_out.data();
+
+#if 1
+	//year
+	pivot += core::to_chars(p_time.date.year, std::span<char8_t, 5>{pivot, 5}) + 6;
+
+	uintptr_t const size = pivot - p_out.data();
+
+	//day
+	*(--pivot) = u8'0' + p_time.date.day % 10;
+	*(--pivot) = u8'0' + p_time.date.day / 10;
+	*(--pivot) = u8'/';
+
+	//month
+	*(--pivot) = u8'0' + p_time.date.month % 10; 
+	*(--pivot) = u8'0' + p_time.date.month / 10; 
+	*(--pivot) = u8'/';
+	return size;
+#else
+	pivot += core::to_chars(p_time.date.year, std::span<char8_t, 5>{pivot, 5});
+	*(pivot++) = u8'/';
+	*(pivot++) = u8'0' + p_time.date.month / 10;
+	*(pivot++) = u8'0' + p_time.date.month % 10;
+	*(pivot++) = u8'/';
+	*(pivot++) = u8'0' + p_time.date.day / 10;
+	*(pivot++) = u8'0' + p_time.date.day % 10;
+
+	return pivot - p_out.data();
+#endif
+}
+
+void format_log_time(core::date_time_t const& p_time, std::span<char8_t, log_time_size> const p_out)
+{
+#if 1
+	char8_t* pivot = p_out.data() + 11;
+
+	//millisecond
+	uint16_t milliseconds = static_cast<uint16_t>(p_time.time.nsecond / 1000000);
+	*(pivot) = u8'0' + static_cast<char8_t>(milliseconds % 10);
+	{
+		char8_t const rem = static_cast<char8_t>(milliseconds / 10);
+		*(--pivot) = u8'0' + rem % 10;
+		*(--pivot) = u8'0' + rem / 10;
+	}
+	*(--pivot) = u8'.';
+
+	//second
+	*(--pivot) = u8'0' + p_time.time.second % 10;
+	*(--pivot) = u8'0' + p_time.time.second / 10;
+	*(--pivot) = u8':';
+
+	//minute
+	*(--pivot) = u8'0' + p_time.time.minute % 10;
+	*(--pivot) = u8'0' + p_time.time.minute / 10;
+	*(--pivot) = u8':';
+
+	//hour
+	*(--pivot) = u8'0' + p_time.time.hour % 10;
+	*(--pivot) = u8'0' + p_time.time.hour / 10;
+#else
+	char8_t* pivot = p_out.data();
+	*(pivot++) = u8'0' + p_time.time.hour / 10;
+	*(pivot++) = u8'0' + p_time.time.hour % 10;
+	*(pivot++) = u8':';
+	*(pivot++) = u8'0' + p_time.time.minute / 10;
+	*(pivot++) = u8'0' + p_time.time.minute % 10;
+	*(pivot++) = u8':';
+	*(pivot++) = u8'0' + p_time.time.second / 10;
+	*(pivot++) = u8'0' + p_time.time.second % 10;
+	*(pivot++) = u8'.';
+
+	uint16_t milliseconds = static_cast<uint16_t>(p_time.time.nsecond / 1000000);
+	pivot += 2;
+	*(pivot) = u8'0' + static_cast<char8_t>(milliseconds % 10);
+	{
+		char8_t const rem = static_cast<char8_t>(milliseconds / 10);
+		*(--pivot) = u8'0' + rem % 10;
+		*(--pivot) = u8'0' + rem / 10;
+	}
+#endif
+}
+
+} //namespace logger
@@ -0,0 +1,104 @@
+//======== ======== ======== ======== ======== ======== ======== ========
+///	\file
+///
+///	\copyright
+///		Copyright (c) Tiago Miguel Oliveira Freire
+///
+///		Permission is hereby granted, free of charge, to any person obtaining a copy
+///		of this software and associated documentation files (the "Software"),
+///		to copy, modify, publish, and/or distribute copies of the Software,
+///		and to permit persons to whom the Software is furnished to do so,
+///		subject to the following conditions:
+///
+///		The copyright notice and this permission notice shall be included in all
+///		copies or substantial portions of the Software.
+///		The copyrighted work, or derived works, shall not be used to train
+///		Artificial Intelligence models of any sort; or otherwise be used in a
+///		transformative way that could obfuscate the source of the copyright.
+///
+///		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+///		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+///		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+///		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+///		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+///		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+///		SOFTWARE.
+//======== ======== ======== ======== ======== ======== ======== ========
+
+
+#include <LogLib/log_deferred.hpp>
+
+#include <CoreLib/toPrint/toPrint.hpp>
+
+namespace logger
+{
+
+template<typename T>
+static inline T read_value(std::byte const*& p_pivot)
+{
+	T val;
+	memcpy(&val, p_pivot, sizeof(T));
+	p_pivot += sizeof(T);
+	return val;
+}
+
+///	\brief Decodes a deferred record calling p_func with a core::toPrint adapter for each argument
+template<typename Func>
+static inline void deferred_visit(std::span<std::byte const> const p_record, Func const& p_func)
+{
+	std::byte const* pivot = p_record.data();
+	std::byte const* const end = pivot + p_record.size();
+
+	while(pivot < end)
+	{
+		switch(static_cast<deferred_tag>(*(pivot++)))
+		{
+			case deferred_tag::u8:  p_func(core::toPrint<uint8_t >{read_value<uint8_t >(pivot)}); break;
+			case deferred_tag::u16: p_func(core::toPrint<uint16_t>{read_value<uint16_t>(pivot)}); break;
+			case deferred_tag::u32: p_func(core::toPrint<uint32_t>{read_value<uint32_t>(pivot)}); break;
+			case deferred_tag::u64: p_func(core::toPrint<uint64_t>{read_value<uint64_t>(pivot)}); break;
+			case deferred_tag::i8:  p_func(core::toPrint<int8_t  >{read_value<int8_t  >(pivot)}); break;
+			case deferred_tag::i16: p_func(core::toPrint<int16_t >{read_value<int16_t >(pivot)}); break;
+			case deferred_tag::i32: p_func(core::toPrint<int32_t >{read_value<int32_t >(pivot)}); break;
+			case deferred_tag::i64: p_func(core::toPrint<int64_t >{read_value<int64_t >(pivot)}); break;
+			case deferred_tag::f32: p_func(core::toPrint<float   >{read_value<float   >(pivot)}); break;
+			case deferred_tag::f64: p_func(core::toPrint<double  >{read_value<double  >(pivot)}); break;
+			case deferred_tag::character:
+				p_func(core::toPrint<char8_t>{static_cast<char8_t>(*(pivot++))});
+				break;
+			case deferred_tag::string:
+				{
+					uint32_t const size = read_value<uint32_t>(pivot);
+					p_func(core::toPrint<std::u8string_view>{std::u8string_view{reinterpret_cast<char8_t const*>(pivot), size}});
+					pivot += size;
+				}
+				break;
+			default:
+				//corrupted record, nothing sensible can be decoded past this point
+				return;
+		}
+	}
+}
+
+uintptr_t deferred_format_size(std::span<std::byte const> const p_record)
+{
+	uintptr_t size = 0;
+	deferred_visit(p_record,
+		[&size](auto const& p_printer)
+		{
+			size += p_printer.size(char8_t{});
+		});
+	return size;
+}
+
+void deferred_format(std::span<std::byte const> const p_record, char8_t* p_out)
+{
+	deferred_visit(p_record,
+		[&p_out](auto const& p_printer)
+		{
+			p_printer.get_print(p_out);
+			p_out += p_printer.size(char8_t{});
+		});
+}
+
+} //namespace logger
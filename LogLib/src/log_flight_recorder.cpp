@@ -0,0 +1,103 @@
+//======== ======== ======== ======== ======== ======== ======== ========
+///	\file
+///
+///	\copyright
+///		Copyright (c) Tiago Miguel Oliveira Freire
+///
+///		Permission is hereby granted, free of charge, to any person obtaining a copy
+///		of this software and associated documentation files (the "Software"),
+///		to copy, modify, publish, and/or distribute copies of the Software,
+///		and to permit persons to whom the Software is furnished to do so,
+///		subject to the following conditions:
+///
+///		The copyright notice and this permission notice shall be included in all
+///		copies or substantial portions of the Software.
+///		The copyrighted work, or derived works, shall not be used to train
+///		Artificial Intelligence models of any sort; or otherwise be used in a
+///		transformative way that could obfuscate the source of the copyright.
+///
+///		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+///		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+///		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+///		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+///		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+///		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+///		SOFTWARE.
+//======== ======== ======== ======== ======== ======== ======== ========
+
+
+#include <LogLib/log_flight_recorder.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <fstream>
+
+namespace logger
+{
+
+bool read_flight_recorder(std::filesystem::path const& p_fileName, uintptr_t const p_max_records, std::vector<std::u8string>& p_records)
+{
+	p_records.clear();
+
+	std::ifstream file{p_fileName, std::ios::binary};
+	if(!file)
+	{
+		return false;
+	}
+
+	_p::flight_recorder_header header;
+	if(!file.read(reinterpret_cast<char*>(&header), sizeof(header))
+		|| memcmp(header.magic, _p::flight_recorder_magic, sizeof(header.magic)) != 0
+		|| header.ring_size < _p::flight_record_alignment
+		|| header.ring_size % _p::flight_record_alignment)
+	{
+		return false;
+	}
+
+	uint64_t const ring_size = header.ring_size;
+	std::vector<char8_t> ring(static_cast<uintptr_t>(ring_size));
+	if(!file.read(reinterpret_cast<char*>(ring.data()), static_cast<std::streamsize>(ring_size)))
+	{
+		return false;
+	}
+
+	//only positions within the last lap can hold records that were not overwritten
+	uint64_t const head = header.head;
+	uint64_t position = head > ring_size ? (head - ring_size + _p::flight_record_alignment - 1) & ~static_cast<uint64_t>(_p::flight_record_alignment - 1) : 0;
+
+	std::deque<std::u8string> records;
+	while(position + sizeof(_p::flight_record_header) <= head)
+	{
+		uintptr_t const offset = static_cast<uintptr_t>(position % ring_size);
+		_p::flight_record_header record;
+		memcpy(&record, ring.data() + offset, sizeof(record));
+
+		if(record.position != position
+			|| record.commit != _p::flight_record_commit(position, record.size)
+			|| position + _p::flight_record_span(record.size) > head
+			|| _p::flight_record_span(record.size) > ring_size)
+		{
+			//incomplete record, or a gap left by one, look for the next record
+			position += _p::flight_record_alignment;
+			continue;
+		}
+
+		std::u8string& text = records.emplace_back(record.size, u8'\0');
+		uintptr_t const start = static_cast<uintptr_t>((position + sizeof(_p::flight_record_header)) % ring_size);
+		uintptr_t const first = std::min<uintptr_t>(record.size, static_cast<uintptr_t>(ring_size) - start);
+		memcpy(text.data(), ring.data() + start, first);
+		memcpy(text.data() + first, ring.data(), record.size - first);
+
+		if(p_max_records && records.size() > p_max_records)
+		{
+			records.pop_front();
+		}
+		position += _p::flight_record_span(record.size);
+	}
+
+	p_records.assign(std::make_move_iterator(records.begin()), std::make_move_iterator(records.end()));
+	return true;
+}
+
+} //namespace logger
@@ -0,0 +1,313 @@
+//======== ======== ======== ======== ======== ======== ======== ========
+///	\file
+///
+///	\copyright
+///		Copyright (c) Tiago Miguel Oliveira Freire
+///
+///		Permission is hereby granted, free of charge, to any person obtaining a copy
+///		of this software and associated documentation files (the "Software"),
+///		to copy, modify, publish, and/or distribute copies of the Software,
+///		and to permit persons to whom the Software is furnished to do so,
+///		subject to the following conditions:
+///
+///		The copyright notice and this permission notice shall be included in all
+///		copies or substantial portions of the Software.
+///		The copyrighted work, or derived works, shall not be used to train
+///		Artificial Intelligence models of any sort; or otherwise be used in a
+///		transformative way that could obfuscate the source of the copyright.
+///
+///		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+///		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+///		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+///		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+///		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+///		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+///		SOFTWARE.
+//======== ======== ======== ======== ======== ======== ======== ========
+
+
+#include <LogLib/log_kv.hpp>
+
+#include <array>
+#include <cmath>
+#include <cstring>
+
+#include <CoreLib/string/core_string_numeric.hpp>
+
+namespace logger
+{
+
+///	\brief Size of the payload of an encoded argument, excluding the tag
+static uintptr_t payload_size(deferred_tag const p_tag, std::byte const* const p_payload, std::byte const* const p_end)
+{
+	switch(p_tag)
+	{
+		case deferred_tag::u8:
+		case deferred_tag::i8:
+		case deferred_tag::character:
+			return 1;
+		case deferred_tag::u16:
+		case deferred_tag::i16:
+			return 2;
+		case deferred_tag::u32:
+		case deferred_tag::i32:
+		case deferred_tag::f32:
+			return 4;
+		case deferred_tag::u64:
+		case deferred_tag::i64:
+		case deferred_tag::f64:
+			return 8;
+		case deferred_tag::string:
+			if(p_end - p_payload >= static_cast<intptr_t>(sizeof(uint32_t)))
+			{
+				uint32_t size;
+				memcpy(&size, p_payload, sizeof(uint32_t));
+				return sizeof(uint32_t) + size;
+			}
+			[[fallthrough]];
+		default:
+			break;
+	}
+	//corrupted record
+	return static_cast<uintptr_t>(p_end - p_payload) + 1;
+}
+
+///	\brief Reads one encoded argument
+///	\return false if the record is exhausted or corrupted
+static bool read_argument(std::byte const*& p_pivot, std::byte const* const p_end, deferred_tag& p_tag, std::span<std::byte const>& p_arg)
+{
+	if(p_pivot >= p_end)
+	{
+		return false;
+	}
+
+	p_tag = static_cast<deferred_tag>(*p_pivot);
+	uintptr_t const size = payload_size(p_tag, p_pivot + 1, p_end);
+	if(size > static_cast<uintptr_t>(p_end - p_pivot - 1))
+	{
+		p_pivot = p_end;
+		return false;
+	}
+
+	p_arg = std::span<std::byte const>{p_pivot, size + 1};
+	p_pivot += size + 1;
+	return true;
+}
+
+static inline std::u8string_view string_payload(std::span<std::byte const> const p_arg)
+{
+	return std::u8string_view{reinterpret_cast<char8_t const*>(p_arg.data() + 1 + sizeof(uint32_t)), p_arg.size() - 1 - sizeof(uint32_t)};
+}
+
+log_kv_reader::log_kv_reader(std::span<std::byte const> const p_record)
+	: m_pivot(p_record.data())
+	, m_end(p_record.data() + p_record.size())
+{
+	deferred_tag tag;
+	std::span<std::byte const> arg;
+	if(read_argument(m_pivot, m_end, tag, arg))
+	{
+		if(tag == deferred_tag::string)
+		{
+			m_message = string_payload(arg);
+		}
+	}
+}
+
+bool log_kv_reader::next(log_kv_entry& p_entry)
+{
+	deferred_tag tag;
+	std::span<std::byte const> key;
+	if(!read_argument(m_pivot, m_end, tag, key) || tag != deferred_tag::string)
+	{
+		m_pivot = m_end;
+		return false;
+	}
+	if(!read_argument(m_pivot, m_end, p_entry.type, p_entry.value))
+	{
+		return false;
+	}
+	p_entry.key = string_payload(key);
+	return true;
+}
+
+namespace
+{
+	class size_counter
+	{
+	public:
+		inline void put(char8_t) { ++m_size; }
+		inline void put(std::u8string_view const p_str) { m_size += p_str.size(); }
+		inline void put_value(std::span<std::byte const> const p_value) { m_size += deferred_format_size(p_value); }
+
+		inline uintptr_t size() const { return m_size; }
+
+	private:
+		uintptr_t m_size = 0;
+	};
+
+	class writer
+	{
+	public:
+		writer(char8_t* const p_out): m_pivot(p_out) {}
+
+		inline void put(char8_t const p_char) { *(m_pivot++) = p_char; }
+		inline void put(std::u8string_view const p_str)
+		{
+			memcpy(m_pivot, p_str.data(), p_str.size());
+			m_pivot += p_str.size();
+		}
+		inline void put_value(std::span<std::byte const> const p_value)
+		{
+			deferred_format(p_value, m_pivot);
+			m_pivot += deferred_format_size(p_value);
+		}
+
+	private:
+		char8_t* m_pivot;
+	};
+} //namespace
+
+///	\brief Puts a string between quotes, escaped with the JSON rules
+template<typename Out>
+static void put_quoted(Out& p_out, std::u8string_view const p_str)
+{
+	p_out.put(u8'"');
+	uintptr_t plain = 0;
+	for(uintptr_t i = 0; i < p_str.size(); ++i)
+	{
+		char8_t const c = p_str[i];
+		if(c != u8'"' && c != u8'\\' && c >= 0x20)
+		{
+			continue;
+		}
+
+		p_out.put(p_str.substr(plain, i - plain));
+		plain = i + 1;
+		p_out.put(u8'\\');
+		switch(c)
+		{
+			case u8'"':  p_out.put(u8'"');  break;
+			case u8'\\': p_out.put(u8'\\'); break;
+			case u8'\n': p_out.put(u8'n');  break;
+			case u8'\r': p_out.put(u8'r');  break;
+			case u8'\t': p_out.put(u8't');  break;
+			default:
+				{
+					std::array<char8_t, 5> code{u8'u', u8'0', u8'0'};
+					core::to_chars_hex_fix(static_cast<uint8_t>(c), std::span<char8_t, 2>{code.data() + 3, 2});
+					p_out.put(std::u8string_view{code.data(), code.size()});
+				}
+				break;
+		}
+	}
+	p_out.put(p_str.substr(plain));
+	p_out.put(u8'"');
+}
+
+///	\brief Puts a field value, strings and characters are quoted
+template<typename Out>
+static void put_value(Out& p_out, deferred_tag const p_type, std::span<std::byte const> const p_value)
+{
+	switch(p_type)
+	{
+		case deferred_tag::string:
+			put_quoted(p_out, string_payload(p_value));
+			break;
+		case deferred_tag::character:
+			put_quoted(p_out, std::u8string_view{reinterpret_cast<char8_t const*>(p_value.data() + 1), 1});
+			break;
+		default:
+			p_out.put_value(p_value);
+			break;
+	}
+}
+
+template<typename Out>
+static void render_text(std::span<std::byte const> const p_record, Out& p_out)
+{
+	log_kv_reader reader{p_record};
+	p_out.put(reader.message());
+
+	log_kv_entry entry;
+	while(reader.next(entry))
+	{
+		p_out.put(u8' ');
+		p_out.put(entry.key);
+		p_out.put(u8'=');
+		put_value(p_out, entry.type, entry.value);
+	}
+}
+
+static bool is_finite(deferred_tag const p_type, std::span<std::byte const> const p_value)
+{
+	if(p_type == deferred_tag::f32)
+	{
+		float val;
+		memcpy(&val, p_value.data() + 1, sizeof(float));
+		return std::isfinite(val);
+	}
+	if(p_type == deferred_tag::f64)
+	{
+		double val;
+		memcpy(&val, p_value.data() + 1, sizeof(double));
+		return std::isfinite(val);
+	}
+	return true;
+}
+
+template<typename Out>
+static void render_json(std::span<std::byte const> const p_record, Out& p_out)
+{
+	log_kv_reader reader{p_record};
+	p_out.put(u8"{\"message\":");
+	put_quoted(p_out, reader.message());
+
+	log_kv_entry entry;
+	while(reader.next(entry))
+	{
+		p_out.put(u8',');
+		put_quoted(p_out, entry.key);
+		p_out.put(u8':');
+		if(is_finite(entry.type, entry.value))
+		{
+			put_value(p_out, entry.type, entry.value);
+		}
+		else
+		{
+			//JSON has no representation for nan or infinity
+			p_out.put(u8'"');
+			p_out.put_value(entry.value);
+			p_out.put(u8'"');
+		}
+	}
+	p_out.put(u8'}');
+}
+
+uintptr_t log_kv_text_size(std::span<std::byte const> const p_record)
+{
+	size_counter counter;
+	render_text(p_record, counter);
+	return counter.size();
+}
+
+void log_kv_format_text(std::span<std::byte const> const p_record, char8_t* const p_out)
+{
+	writer out{p_out};
+	render_text(p_record, out);
+}
+
+uintptr_t log_kv_json_size(std::span<std::byte const> const p_record)
+{
+	size_counter counter;
+	render_json(p_record, counter);
+	return counter.size();
+}
+
+void log_kv_format_json(std::span<std::byte const> const p_record, char8_t* const p_out)
+{
+	writer out{p_out};
+	render_json(p_record, out);
+}
+
+} //namespace logger
@@ -0,0 +1,147 @@
+//======== ======== ======== ======== ======== ======== ======== ========
+///	\file
+///
+///	\copyright
+///		Copyright (c) Tiago Miguel Oliveira Freire
+///
+///		Permission is hereby granted, free of charge, to any person obtaining a copy
+///		of this software and associated documentation files (the "Software"),
+///		to copy, modify, publish, and/or distribute copies of the Software,
+///		and to permit persons to whom the Software is furnished to do so,
+///		subject to the following conditions:
+///
+///		The copyright notice and this permission notice shall be included in all
+///		copies or substantial portions of the Software.
+///		The copyrighted work, or derived works, shall not be used to train
+///		Artificial Intelligence models of any sort; or otherwise be used in a
+///		transformative way that could obfuscate the source of the copyright.
+///
+///		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+///		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+///		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+///		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+///		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+///		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+///		SOFTWARE.
+//======== ======== ======== ======== ======== ======== ======== ========
+
+
+#include <LogLib/log_rule_filter.hpp>
+
+#include <utility>
+
+namespace logger
+{
+
+static inline bool is_separator(core::os_char const p_char)
+{
+	return p_char == '/' || p_char == '\\';
+}
+
+static inline bool char_match(core::os_char const p_pattern, core::os_char const p_char)
+{
+	return p_pattern == '?' || p_pattern == p_char || (is_separator(p_pattern) && is_separator(p_char));
+}
+
+///	\brief Wildcard match, linear time with single backtracking point
+static bool glob_match(core::os_string_view const p_pattern, core::os_string_view const p_text)
+{
+	uintptr_t p = 0;
+	uintptr_t t = 0;
+	uintptr_t star = core::os_string_view::npos;
+	uintptr_t star_text = 0;
+
+	while(t < p_text.size())
+	{
+		if(p < p_pattern.size() && p_pattern[p] == '*')
+		{
+			star = p++;
+			star_text = t;
+		}
+		else if(p < p_pattern.size() && char_match(p_pattern[p], p_text[t]))
+		{
+			++p;
+			++t;
+		}
+		else if(star != core::os_string_view::npos)
+		{
+			p = star + 1;
+			t = ++star_text;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	while(p < p_pattern.size() && p_pattern[p] == '*')
+	{
+		++p;
+	}
+	return p == p_pattern.size();
+}
+
+static inline bool pattern_match(core::os_string const& p_pattern, core::os_string_view const p_text)
+{
+	return p_pattern.empty() || glob_match(p_pattern, p_text);
+}
+
+uintptr_t log_rule_filter::scope_key_hash::operator () (scope_key const& p_key) const
+{
+	uintptr_t const module = reinterpret_cast<uintptr_t>(p_key.module_base);
+	uintptr_t const file   = reinterpret_cast<uintptr_t>(p_key.file);
+	return (module * 0x9E3779B97F4A7C15ull) ^ (file + (module << 6) + (module >> 2));
+}
+
+log_rule_filter::log_rule_filter(std::vector<log_filter_rule> p_rules, Level const p_default_level)
+	: m_rules		(std::move(p_rules))
+	, m_default_rank(level_rank(p_default_level))
+{
+}
+
+log_rule_filter::~log_rule_filter() = default;
+
+log_rule_filter::scope const& log_rule_filter::get_scope(log_filter_data const& p_data) const
+{
+	scope_key const key{p_data.module_base, p_data.file.data()};
+	{
+		core::atomic_spinlock::scope_locker const lock{m_lock};
+		auto const it = m_scopes.find(key);
+		if(it != m_scopes.end())
+		{
+			return *it->second;
+		}
+	}
+
+	//first time this module and file are seen, resolve which rules apply
+	std::unique_ptr<scope> compiled = std::make_unique<scope>();
+	for(log_filter_rule const& rule: m_rules)
+	{
+		if(pattern_match(rule.module_pattern, p_data.module_name) && pattern_match(rule.file_pattern, p_data.file))
+		{
+			compiled->push_back(scope_rule{rule.line_min, rule.line_max, level_rank(rule.min_level)});
+		}
+	}
+
+	core::atomic_spinlock::scope_locker const lock{m_lock};
+	//another thread may have compiled the same scope in the mean time
+	return *m_scopes.try_emplace(key, std::move(compiled)).first->second;
+}
+
+bool log_rule_filter::filter(log_filter_data const& p_data) const
+{
+	scope const& rules = get_scope(p_data);
+
+	uint8_t min_rank = m_default_rank;
+	for(auto it = rules.crbegin(), it_end = rules.crend(); it != it_end; ++it)
+	{
+		if(p_data.line >= it->line_min && p_data.line <= it->line_max)
+		{
+			min_rank = it->min_rank;
+			break;
+		}
+	}
+	return level_rank(p_data.level) >= min_rank;
+}
+
+} //namespace logger
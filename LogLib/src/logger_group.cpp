@@ -29,21 +29,26 @@
 
 #include <span>
 #include <array>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <thread>
+#include <utility>
 
 #include <CoreLib/core_time.hpp>
 #include <CoreLib/core_thread.hpp>
 #include <CoreLib/string/core_os_string.hpp>
 #include <CoreLib/string/core_string_numeric.hpp>
+#include <CoreLib/core_alloca.hpp>
 
 #include <LogLib/log_filter.hpp>
+#include <LogLib/log_scratch.hpp>
+#include <LogLib/log_clock.hpp>
+#include <LogLib/log_deferred.hpp>
 #include <LogLib/logger_struct.hpp>
 #include <LogLib/sink/log_sink.hpp>
 
 
-//Right now we are enforcing validity by having buffer larger than what we would theorethically need
-static constexpr uintptr_t g_DateMessageSize = sizeof("00000/00/00") - 1;
-static constexpr uintptr_t g_TimeMessageSize = sizeof("00:00:00.000") - 1;
-
 /// \n
 namespace logger
 {
@@ -56,90 +61,46 @@ static core::thread_id_t getCurrentThreadId()
 	return threadId;
 }
 
-[[maybe_unused]]
-static uintptr_t FormatDate(core::date_time_t const& p_time, std::span<char8_t, g_DateMessageSize> const p_out)
+static void FormatMillisecond(uint32_t const p_nsecond, std::span<char8_t, log_time_size> const p_out)
 {
-	char8_t* pivot = p_out.data();
-
-#if 1
-	//year
-	pivot += core::to_chars(p_time.date.year, std::span<char8_t, 5>{pivot, 5}) + 6;
-
-	uintptr_t const size = pivot - p_out.data();
-
-	//day
-	*(--pivot) = u8'0' + p_time.date.day % 10;
-	*(--pivot) = u8'0' + p_time.date.day / 10;
-	*(--pivot) = u8'/';
-
-	//month
-	*(--pivot) = u8'0' + p_time.date.month % 10; 
-	*(--pivot) = u8'0' + p_time.date.month / 10; 
-	*(--pivot) = u8'/';
-	return size;
-#else
-	pivot += core::to_chars(p_time.date.year, std::span<char8_t, 5>{pivot, 5});
-	*(pivot++) = u8'/';
-	*(pivot++) = u8'0' + p_time.date.month / 10;
-	*(pivot++) = u8'0' + p_time.date.month % 10;
-	*(pivot++) = u8'/';
-	*(pivot++) = u8'0' + p_time.date.day / 10;
-	*(pivot++) = u8'0' + p_time.date.day % 10;
-
-	return pivot - p_out.data();
-#endif
+	uint16_t const milliseconds = static_cast<uint16_t>(p_nsecond / 1000000);
+	p_out[11] = u8'0' + static_cast<char8_t>(milliseconds % 10);
+	char8_t const rem = static_cast<char8_t>(milliseconds / 10);
+	p_out[10] = u8'0' + rem % 10;
+	p_out[9]  = u8'0' + rem / 10;
 }
 
-[[maybe_unused]]
-static void FormatTime(core::date_time_t const& p_time, std::span<char8_t, g_TimeMessageSize> const p_out)
+///	\brief Per thread cache of the rendered date and time.
+///		The calendar conversion and formatting is only done when the second changes, otherwise only the milliseconds are patched.
+struct time_cache
 {
-#if 1
-	char8_t* pivot = p_out.data() + 11;
-
-	//millisecond
-	uint16_t milliseconds = static_cast<uint16_t>(p_time.time.nsecond / 1000000);
-	*(pivot) = u8'0' + static_cast<char8_t>(milliseconds % 10);
-	{
-		char8_t const rem = static_cast<char8_t>(milliseconds / 10);
-		*(--pivot) = u8'0' + rem % 10;
-		*(--pivot) = u8'0' + rem / 10;
-	}
-	*(--pivot) = u8'.';
-
-	//second
-	*(--pivot) = u8'0' + p_time.time.second % 10;
-	*(--pivot) = u8'0' + p_time.time.second / 10;
-	*(--pivot) = u8':';
-
-	//minute
-	*(--pivot) = u8'0' + p_time.time.minute % 10;
-	*(--pivot) = u8'0' + p_time.time.minute / 10;
-	*(--pivot) = u8':';
+	std::chrono::sys_seconds second = std::chrono::sys_seconds::min();
+	core::date_time_t time_struct;
+	uintptr_t date_size = 0;
+	std::array<char8_t, log_date_max_size> date;
+	std::array<char8_t, log_time_size> time;
+};
+
+static time_cache const& get_time_cache()
+{
+	thread_local static time_cache cache;
 
-	//hour
-	*(--pivot) = u8'0' + p_time.time.hour % 10;
-	*(--pivot) = u8'0' + p_time.time.hour / 10;
-#else
-	char8_t* pivot = p_out.data();
-	*(pivot++) = u8'0' + p_time.time.hour / 10;
-	*(pivot++) = u8'0' + p_time.time.hour % 10;
-	*(pivot++) = u8':';
-	*(pivot++) = u8'0' + p_time.time.minute / 10;
-	*(pivot++) = u8'0' + p_time.time.minute % 10;
-	*(pivot++) = u8':';
-	*(pivot++) = u8'0' + p_time.time.second / 10;
-	*(pivot++) = u8'0' + p_time.time.second % 10;
-	*(pivot++) = u8'.';
+	//the calendar fields and the sub-second part must come from the same sample
+	std::chrono::system_clock::time_point const now = std::chrono::system_clock::now();
+	std::chrono::sys_seconds const second = std::chrono::floor<std::chrono::seconds>(now);
+	uint32_t const nsecond = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - second).count());
 
-	uint16_t milliseconds = static_cast<uint16_t>(p_time.time.nsecond / 1000000);
-	pivot += 2;
-	*(pivot) = u8'0' + static_cast<char8_t>(milliseconds % 10);
+	if(second != cache.second)
 	{
-		char8_t const rem = static_cast<char8_t>(milliseconds / 10);
-		*(--pivot) = u8'0' + rem % 10;
-		*(--pivot) = u8'0' + rem / 10;
+		cache.second = second;
+		cache.time_struct = log_date_time(second);
+		cache.date_size = format_log_date(cache.time_struct, cache.date);
+		format_log_time(cache.time_struct, cache.time);
 	}
-#endif
+
+	cache.time_struct.time.nsecond = nsecond;
+	FormatMillisecond(nsecond, cache.time);
+	return cache;
 }
 
 [[maybe_unused]]
@@ -171,6 +132,18 @@ static uintptr_t FormatLogLevel(Level const p_level, std::span<char8_t, 9> const
 				memcpy(p_out.data(), text.data(), text.size());
 				return text.size();
 			}
+		case Level::Verbose:
+			{
+				constexpr std::u8string_view text = u8"Verbose";
+				memcpy(p_out.data(), text.data(), text.size());
+				return text.size();
+			}
+		case Level::Trace:
+			{
+				constexpr std::u8string_view text = u8"Trace";
+				memcpy(p_out.data(), text.data(), text.size());
+				return text.size();
+			}
 		default:
 			break;
 	}
@@ -183,65 +156,512 @@ static uintptr_t FormatLogLevel(Level const p_level, std::span<char8_t, 9> const
 	}
 }
 
-//======== ======== ======== ======== Class: LoggerHelper ======== ======== ======== ========
+///	\brief Storage for the derived fields of a record
+struct record_fields
+{
+	std::array<char8_t, 9> level;
+	std::array<char8_t, log_date_max_size> date;
+	std::array<char8_t, log_time_size> time;
+	std::array<char8_t, core::to_chars_dec_max_size_v<core::thread_id_t>> thread;
+	std::array<char8_t, 10> line;
+	std::array<char8_t, 10> column;
+};
 
-void LoggerGroup::log(log_message_data const& data, std::u8string_view message)
+///	\brief Time information shared by the records being dispatched
+struct captured_time
 {
-	log_data tlog_data = data;
+	uint64_t timestamp = 0;
+	time_cache const* cache = nullptr;
+};
+
+static captured_time capture_time(log_field const p_fields)
+{
+	captured_time time;
+	if(has_field(p_fields, log_field::timestamp))
+	{
+		time.timestamp = log_clock_ticks();
+	}
+	if(has_field(p_fields, log_field::date | log_field::time))
+	{
+		time.cache = &get_time_cache();
+	}
+	return time;
+}
+
+static void format_fields(log_data& p_data, record_fields& p_storage, log_field const p_fields, captured_time const& p_time)
+{
+	p_data.thread_id = getCurrentThreadId();
+	p_data.timestamp = p_time.timestamp;
 
-	tlog_data.time_struct = core::system_time_to_date(core::system_time_fast());
-	tlog_data.thread_id = getCurrentThreadId();
-	tlog_data.message = message;
 	//category
-	std::array<char8_t, 9> level;
-	uintptr_t const level_size = FormatLogLevel(data.level, level);
+	if(has_field(p_fields, log_field::level))
+	{
+		uintptr_t const level_size = FormatLogLevel(p_data.level, p_storage.level);
+		p_data.sv_level = std::u8string_view(p_storage.level.data(), level_size);
+	}
 
-	//date
-	std::array<char8_t, g_DateMessageSize> date;
-	uintptr_t const date_size = FormatDate(tlog_data.time_struct, date);
-	
-	//time
-	std::array<char8_t, g_TimeMessageSize> time;
-	constexpr uintptr_t time_size = 12; FormatTime(tlog_data.time_struct, time);
+	//a sink may log from within output, copies are kept so that the cache can be refreshed
+	if(p_time.cache)
+	{
+		time_cache const& time_info = *p_time.cache;
+		p_data.time_struct = time_info.time_struct;
+
+		//date
+		if(has_field(p_fields, log_field::date))
+		{
+			p_storage.date = time_info.date;
+			p_data.sv_date = std::u8string_view(p_storage.date.data(), time_info.date_size);
+		}
+
+		//time
+		if(has_field(p_fields, log_field::time))
+		{
+			p_storage.time = time_info.time;
+			p_data.sv_time = std::u8string_view(p_storage.time.data(), p_storage.time.size());
+		}
+	}
 
 	//thread
-	std::array<char8_t, core::to_chars_dec_max_size_v<core::thread_id_t>> thread;
-	uintptr_t const thread_size = core::to_chars(tlog_data.thread_id, thread);
+	if(has_field(p_fields, log_field::thread))
+	{
+		uintptr_t const thread_size = core::to_chars(p_data.thread_id, p_storage.thread);
+		p_data.sv_thread = std::u8string_view(p_storage.thread.data(), thread_size);
+	}
 
 	//line
-	std::array<char8_t, 10> line;
-	uintptr_t const line_size = core::to_chars(data.line, line);
+	if(has_field(p_fields, log_field::line))
+	{
+		uintptr_t const line_size = core::to_chars(p_data.line, p_storage.line);
+		p_data.sv_line = std::u8string_view(p_storage.line.data(), line_size);
+	}
 
 	//column
-	std::array<char8_t, 10> column;
-	uintptr_t const column_size = core::to_chars(data.column, column);
+	if(has_field(p_fields, log_field::column))
+	{
+		uintptr_t const column_size = core::to_chars(p_data.column, p_storage.column);
+		p_data.sv_column = std::u8string_view(p_storage.column.data(), column_size);
+	}
+}
+
+//======== ======== ======== ======== Message sources ======== ======== ======== ========
+
+namespace
+{
+	class text_source final: public log_message_source
+	{
+	public:
+		text_source(std::u8string_view const p_message)
+			: m_message(p_message)
+		{
+			m_size = p_message.size();
+		}
+
+		void render(char8_t* const p_out) const final
+		{
+			memcpy(p_out, m_message.data(), m_message.size());
+		}
+
+	private:
+		std::u8string_view const m_message;
+	};
+
+	class deferred_source final: public log_message_source
+	{
+	public:
+		deferred_source(std::span<std::byte const> const p_record)
+			: m_record(p_record)
+		{
+			//the arguments are only formatted if a sink needs the rendered message
+			m_size = unknown_size;
+		}
+
+		void render(char8_t* const p_out) const final
+		{
+			deferred_format(m_record, p_out);
+		}
+
+	private:
+		uintptr_t compute_size() const final
+		{
+			return deferred_format_size(m_record);
+		}
+
+		std::span<std::byte const> const m_record;
+	};
+} //namespace
+
+//======== ======== ======== ======== Class: LoggerHelper ======== ======== ======== ========
+
+struct LoggerGroup::sink_entry
+{
+	log_sink* sink;
+	log_sink_filter filter;
+	log_field fields;       //!< cached \ref log_sink::required_fields
+	bool accepts_deferred;  //!< cached \ref log_sink::accepts_deferred
+
+	inline bool accepts(Level const p_level, void const* const p_module_base) const
+	{
+		return level_rank(p_level) >= level_rank(filter.min_level)
+			&& (filter.module_base == nullptr || filter.module_base == p_module_base);
+	}
+};
+
+struct LoggerGroup::snapshot
+{
+	std::vector<sink_entry> sinks;
+
+	/// lowest level accepted by any of the sinks, used to quickly reject logs
+	Level min_level = Level::Trace;
+
+	/// union of the fields required by the sinks
+	log_field fields = log_field::none;
+};
+
+///	\brief Fields required by the sinks that accept a particular log
+struct LoggerGroup::selection
+{
+	log_field fields = log_field::none;
+	log_field deferred_fields = log_field::none; //!< Only of the sinks that do not accept deferred messages
+	bool any = false;
+
+	selection(snapshot const& p_sinks, Level const p_level, void const* const p_module_base)
+	{
+		if(level_rank(p_level) < level_rank(p_sinks.min_level)) return;
+
+		for(sink_entry const& entry: p_sinks.sinks)
+		{
+			if(entry.accepts(p_level, p_module_base))
+			{
+				any = true;
+				fields |= entry.fields;
+				if(!entry.accepts_deferred)
+				{
+					deferred_fields |= entry.fields;
+				}
+			}
+		}
+	}
+};
+
+///	\brief Keeps the current snapshot alive for the duration of the scope
+class LoggerGroup::read_scope
+{
+public:
+	read_scope(LoggerGroup& p_group)
+		: m_count(p_group.m_readers[p_group.m_epoch.load(std::memory_order::relaxed) & 1].count)
+	{
+		m_count.fetch_add(1, std::memory_order::seq_cst);
+		m_snapshot = p_group.m_snapshot.load(std::memory_order::seq_cst);
+	}
+
+	~read_scope()
+	{
+		m_count.fetch_sub(1, std::memory_order::release);
+	}
+
+	read_scope(read_scope const&) = delete;
+	read_scope& operator = (read_scope const&) = delete;
+
+	inline snapshot const* get() const { return m_snapshot; }
+
+private:
+	std::atomic<uintptr_t>& m_count;
+	snapshot const* m_snapshot;
+};
+
+LoggerGroup::LoggerGroup() = default;
 
-	tlog_data.sv_line   = std::u8string_view(line  .data(), line_size);
-	tlog_data.sv_column = std::u8string_view(column.data(), column_size);
-	tlog_data.sv_date   = std::u8string_view(date  .data(), date_size);
-	tlog_data.sv_time   = std::u8string_view(time  .data(), time_size);
-	tlog_data.sv_thread = std::u8string_view(thread.data(), thread_size);
-	tlog_data.sv_level  = std::u8string_view(level .data(), level_size);
+LoggerGroup::~LoggerGroup()
+{
+	delete m_snapshot.load(std::memory_order::acquire);
+}
+
+bool LoggerGroup::accepts(Level const p_level, void const* const p_module_base)
+{
+	read_scope const scope{*this};
+	snapshot const* const sinks = scope.get();
+	return sinks && selection{*sinks, p_level, p_module_base}.any;
+}
+
+void LoggerGroup::prepare_thread(uintptr_t const p_scratch_size)
+{
+	_p::scratch_arena::local().reserve(p_scratch_size);
+
+	read_scope const scope{*this};
+	snapshot const* const sinks = scope.get();
+	if(sinks == nullptr) return;
+
+	for(sink_entry const& entry: sinks->sinks)
+	{
+		entry.sink->prepare_thread();
+	}
+}
+
+void LoggerGroup::log(log_message_data const& data, std::u8string_view message)
+{
+	read_scope const scope{*this};
+	snapshot const* const sinks = scope.get();
+	if(sinks == nullptr) return;
+
+	selection const selected{*sinks, data.level, data.module_base};
+	if(!selected.any) return;
+
+	dispatch(*sinks, selected.fields, data, message, {}, text_source{message});
+}
+
+void LoggerGroup::log(log_message_data const& data, log_message_source const& message)
+{
+	read_scope const scope{*this};
+	snapshot const* const sinks = scope.get();
+	if(sinks == nullptr) return;
+
+	selection const selected{*sinks, data.level, data.module_base};
+	if(!selected.any) return;
+
+	if(!has_field(selected.fields, log_field::message))
+	{
+		dispatch(*sinks, selected.fields, data, {}, {}, message);
+		return;
+	}
+
+	uintptr_t const message_size = message.size();
+	constexpr uintptr_t alloca_treshold = 0x10000;
+
+	if(message_size > alloca_treshold)
+	{
+		log_scratch<char8_t> const buff{message_size};
+		message.render(buff.data());
+		dispatch(*sinks, selected.fields, data, std::u8string_view{buff.data(), message_size}, {}, message);
+	}
+	else
+	{
+		char8_t* const buff = reinterpret_cast<char8_t*>(core_alloca(message_size));
+		message.render(buff);
+		dispatch(*sinks, selected.fields, data, std::u8string_view{buff, message_size}, {}, message);
+	}
+}
+
+void LoggerGroup::log_deferred(log_message_data const& data, std::span<std::byte const> record)
+{
+	//an empty record must still be distinguishable from a message that was not deferred
+	static constexpr std::byte empty_record{};
+	if(record.data() == nullptr)
+	{
+		record = std::span<std::byte const>{&empty_record, 0};
+	}
+
+	read_scope const scope{*this};
+	snapshot const* const sinks = scope.get();
+	if(sinks == nullptr) return;
+
+	selection const selected{*sinks, data.level, data.module_base};
+	if(!selected.any) return;
 
-	for(log_sink* const sink: m_sinks)
+	deferred_source const source{record};
+
+	if(!has_field(selected.deferred_fields, log_field::message))
+	{
+		dispatch(*sinks, selected.fields, data, {}, record, source);
+		return;
+	}
+
+	uintptr_t const message_size = source.size();
+	constexpr uintptr_t alloca_treshold = 0x10000;
+
+	if(message_size > alloca_treshold)
+	{
+		log_scratch<char8_t> const buff{message_size};
+		source.render(buff.data());
+		dispatch(*sinks, selected.fields, data, std::u8string_view{buff.data(), message_size}, record, source);
+	}
+	else
 	{
-		sink->output(tlog_data);
+		char8_t* const buff = reinterpret_cast<char8_t*>(core_alloca(message_size));
+		source.render(buff);
+		dispatch(*sinks, selected.fields, data, std::u8string_view{buff, message_size}, record, source);
 	}
 }
 
-void LoggerGroup::add_sink(log_sink& p_sink)
+void LoggerGroup::dispatch(snapshot const& sinks, log_field const fields, log_message_data const& data, std::u8string_view const message, std::span<std::byte const> const deferred, log_message_source const& source)
 {
-	m_sinks.push_back(&p_sink);
+	log_data tlog_data = data;
+	tlog_data.message = message;
+	tlog_data.deferred_message = deferred;
+	tlog_data.message_source = &source;
+
+	record_fields storage;
+	format_fields(tlog_data, storage, fields, capture_time(fields));
+
+	for(sink_entry const& entry: sinks.sinks)
+	{
+		if(entry.accepts(data.level, data.module_base))
+		{
+			entry.sink->output(tlog_data);
+		}
+	}
+}
+
+void LoggerGroup::log_batch(std::span<log_message_record const> records)
+{
+	//records are prepared in chunks to bound the stack usage
+	constexpr uintptr_t chunk_size = 32;
+
+	read_scope const scope{*this};
+	snapshot const* const sinks = scope.get();
+	if(sinks == nullptr) return;
+
+	log_field const fields = sinks->fields;
+	bool const needs_text = has_field(fields, log_field::message);
+
+	//all records of the batch are considered to be submitted at the same time
+	captured_time const time = capture_time(fields);
+
+	std::array<log_data, chunk_size> batch;
+	std::array<record_fields, chunk_size> storage;
+	std::array<log_data, chunk_size> filtered;
+
+	while(!records.empty())
+	{
+		uintptr_t const count = std::min(records.size(), chunk_size);
+		std::span<log_message_record const> const chunk = records.first(count);
+		records = records.subspan(count);
+
+		uintptr_t text_size = 0;
+		if(needs_text)
+		{
+			for(log_message_record const& record: chunk)
+			{
+				text_size += record.message->size();
+			}
+		}
+
+		log_scratch<char8_t> const text{text_size};
+		char8_t* pivot = text.data();
+		for(uintptr_t i = 0; i < count; ++i)
+		{
+			log_message_record const& record = chunk[i];
+			log_data& tlog_data = batch[i];
+			tlog_data = log_data{record.data};
+			tlog_data.message_source = record.message;
+			if(needs_text)
+			{
+				record.message->render(pivot);
+				tlog_data.message = std::u8string_view{pivot, record.message->size()};
+				pivot += record.message->size();
+			}
+			format_fields(tlog_data, storage[i], fields, time);
+		}
+
+		std::span<log_data const> const out{batch.data(), count};
+		for(sink_entry const& entry: sinks->sinks)
+		{
+			//sinks only receive the records they accept
+			uintptr_t filtered_count = 0;
+			for(log_data const& tlog_data: out)
+			{
+				if(entry.accepts(tlog_data.level, tlog_data.module_base))
+				{
+					filtered[filtered_count++] = tlog_data;
+				}
+			}
+
+			if(filtered_count == out.size())
+			{
+				entry.sink->output_batch(out);
+			}
+			else if(filtered_count)
+			{
+				entry.sink->output_batch(std::span<log_data const>{filtered.data(), filtered_count});
+			}
+		}
+	}
+}
+
+void LoggerGroup::synchronize()
+{
+	//waits for the readers of both epochs, readers that start after the flip
+	//can only observe the new snapshot and do not delay the writer
+	uint32_t const epoch = m_epoch.load(std::memory_order::relaxed) & 1;
+	while(m_readers[epoch ^ 1].count.load(std::memory_order::seq_cst) != 0)
+	{
+		std::this_thread::yield();
+	}
+	m_epoch.store(epoch ^ 1, std::memory_order::seq_cst);
+	while(m_readers[epoch].count.load(std::memory_order::seq_cst) != 0)
+	{
+		std::this_thread::yield();
+	}
+}
+
+void LoggerGroup::publish(std::vector<sink_entry> p_sinks)
+{
+	snapshot* next = nullptr;
+	if(!p_sinks.empty())
+	{
+		next = new snapshot;
+		next->min_level = p_sinks.front().filter.min_level;
+		for(sink_entry const& entry: p_sinks)
+		{
+			next->fields |= entry.fields;
+			if(level_rank(entry.filter.min_level) < level_rank(next->min_level))
+			{
+				next->min_level = entry.filter.min_level;
+			}
+		}
+		next->sinks = std::move(p_sinks);
+	}
+
+	snapshot const* const previous = m_snapshot.exchange(next, std::memory_order::seq_cst);
+	synchronize();
+	delete previous;
+}
+
+std::vector<LoggerGroup::sink_entry> LoggerGroup::current_sinks() const
+{
+	snapshot const* const current = m_snapshot.load(std::memory_order::relaxed);
+	if(current)
+	{
+		return current->sinks;
+	}
+	return {};
+}
+
+void LoggerGroup::add_sink(log_sink& p_sink, log_sink_filter const& p_filter)
+{
+	core::atomic_spinlock::scope_locker const lock{m_write_lock};
+	std::vector<sink_entry> sinks = current_sinks();
+	sinks.push_back(sink_entry{&p_sink, p_filter, p_sink.required_fields(), p_sink.accepts_deferred()});
+	publish(std::move(sinks));
+}
+
+bool LoggerGroup::set_sink_filter(log_sink& p_sink, log_sink_filter const& p_filter)
+{
+	core::atomic_spinlock::scope_locker const lock{m_write_lock};
+	std::vector<sink_entry> sinks = current_sinks();
+	for(sink_entry& entry: sinks)
+	{
+		if(entry.sink == &p_sink)
+		{
+			entry.filter = p_filter;
+			publish(std::move(sinks));
+			return true;
+		}
+	}
+	return false;
 }
 
 void LoggerGroup::remove_sink(log_sink& p_sink)
 {
+	core::atomic_spinlock::scope_locker const lock{m_write_lock};
+	std::vector<sink_entry> sinks = current_sinks();
+
 	log_sink* const sink_addr = &p_sink;
-	for(decltype(m_sinks)::const_iterator it = m_sinks.cbegin(), it_end = m_sinks.cend(); it != it_end; ++it)
+	for(decltype(sinks)::const_iterator it = sinks.cbegin(), it_end = sinks.cend(); it != it_end; ++it)
 	{
-		if((*it) == sink_addr)
+		if(it->sink == sink_addr)
 		{
-			m_sinks.erase(it);
+			sinks.erase(it);
+			publish(std::move(sinks));
 			return;
 		}
 	}
@@ -249,7 +669,8 @@ void LoggerGroup::remove_sink(log_sink& p_sink)
 
 void LoggerGroup::clear()
 {
-	m_sinks.clear();
+	core::atomic_spinlock::scope_locker const lock{m_write_lock};
+	publish({});
 }
 
 }// namespace logger
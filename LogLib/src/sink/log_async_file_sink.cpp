@@ -29,10 +29,19 @@
 
 #include <array>
 #include <vector>
+#include <optional>
+#include <limits>
+#include <thread>
 #include <utility>
 
 #include <CoreLib/string/core_string_encoding.hpp>
-#include <CoreLib/core_alloca.hpp>
+#include <CoreLib/string/core_string_numeric.hpp>
+#include <CoreLib/core_time.hpp>
+
+#include <LogLib/log_clock.hpp>
+#include <LogLib/log_deferred.hpp>
+#include <LogLib/log_ring_buffer.hpp>
+#include <LogLib/log_record_pool.hpp>
 
 namespace logger
 {
@@ -43,45 +52,195 @@ static inline void transfer(char8_t*& p_buff, std::u8string_view const p_str)
 	p_buff += p_str.size();
 }
 
+static std::atomic<uint64_t> g_sink_id = 0;
+
+static constexpr uintptr_t prefix_max_size = log_date_max_size + log_time_size + 2; //[-
+
+static constexpr std::u8string_view repeats_intro = u8"] Last message repeated ";
+static constexpr std::u8string_view repeats_outro = u8" times\n";
+static constexpr uintptr_t repeats_count_max_size = core::to_chars_dec_max_size_v<uint64_t>;
+static constexpr uintptr_t repeats_max_size = prefix_max_size + repeats_intro.size() + repeats_count_max_size + repeats_outro.size();
+
+struct log_async_file_sink::record_header
+{
+	uint64_t  stamp;        //!< Used to merge the records of the different threads
+	uint32_t  size;         //!< Size of the record data
+	uint32_t  deferred_pos; //!< Start of the deferred arguments in data, equal to size if message was already rendered
+	Level     level;
+	char8_t*  external;     //!< Data of records too large for the thread buffer (see \ref _p::record_pool), nullptr if data follows the header
+};
+
+struct log_async_file_sink::thread_buffer
+{
+	thread_buffer(uintptr_t const p_size)
+	{
+		ring.emplace(p_size);
+	}
+
+	std::optional<_p::spsc_ring> ring; //!< Released by \ref end, the thread caches can outlive the sink
+	std::atomic<bool> closed = false;  //!< Set by \ref end, tells the thread caches to drop the buffer
+};
+
+
+///	\brief Registers a logging thread as a user of the thread buffers, \ref log_async_file_sink::end waits for them to leave before releasing the buffers
+class log_async_file_sink::producer_scope
+{
+public:
+	producer_scope(log_async_file_sink& p_sink)
+		: m_sink(p_sink)
+	{
+		//pairs with end, either end sees this thread as a user, or this thread sees the sink is no longer accepting records
+		m_sink.m_producers.fetch_add(1, std::memory_order::seq_cst);
+		m_accepted = m_sink.m_accepting.load(std::memory_order::seq_cst);
+	}
+
+	~producer_scope()
+	{
+		m_sink.m_producers.fetch_sub(1, std::memory_order::release);
+	}
+
+	producer_scope(producer_scope const&) = delete;
+	producer_scope& operator = (producer_scope const&) = delete;
+
+	inline bool accepted() const { return m_accepted; }
 
-log_async_file_sink::log_async_file_sink() = default;
+private:
+	log_async_file_sink& m_sink;
+	bool m_accepted;
+};
+
+
+log_async_file_sink::log_async_file_sink()
+	: m_pool(std::make_unique<_p::record_pool>())
+{
+}
 
 log_async_file_sink::~log_async_file_sink()
 {
 	end();
 }
 
+log_async_file_sink::thread_buffer& log_async_file_sink::get_thread_buffer()
+{
+	struct cache_entry
+	{
+		uint64_t id;
+		std::shared_ptr<thread_buffer> buffer;
+	};
+
+	//keeps the buffers alive for as long as the thread might use them,
+	//once the thread exits the writer thread can reclaim them
+	thread_local static std::vector<cache_entry> t_cache;
+
+	for(cache_entry const& entry: t_cache)
+	{
+		if(entry.id == m_id)
+		{
+			return *entry.buffer;
+		}
+	}
+
+	std::shared_ptr<thread_buffer> buffer = std::make_shared<thread_buffer>(m_thread_buffer_size);
+	{
+		core::atomic_spinlock::scope_locker const lock{m_lock};
+		m_buffers.push_back(buffer);
+		m_generation.fetch_add(1, std::memory_order::seq_cst);
+	}
+
+	//drop entries of sinks that have since been closed
+	std::erase_if(t_cache, [](cache_entry const& p_entry) { return p_entry.buffer->closed.load(std::memory_order::relaxed); });
+	return *t_cache.emplace_back(m_id, std::move(buffer)).buffer;
+}
+
+void log_async_file_sink::wake_writer()
+{
+	if(m_waiting.load(std::memory_order::seq_cst) && m_waiting.exchange(false, std::memory_order::acq_rel))
+	{
+		m_trap.signal();
+	}
+}
 
 void log_async_file_sink::output(log_data const& p_logData)
 {
-	if(!m_file.is_open()) return;
+	producer_scope const scope{*this};
+	if(!scope.accepted()) return;
+
+	thread_buffer& buffer = get_thread_buffer();
+	push_record(buffer, p_logData);
+	buffer.ring->commit();
+	wake_writer();
+}
+
+void log_async_file_sink::output_batch(std::span<log_data const> const p_records)
+{
+	producer_scope const scope{*this};
+	if(!scope.accepted()) return;
 
+	//records are published all at once, waking the writer only once
+	thread_buffer& buffer = get_thread_buffer();
+	for(log_data const& record: p_records)
+	{
+		if(!push_record(buffer, record)) break;
+	}
+	buffer.ring->commit();
+	wake_writer();
+}
+
+bool log_async_file_sink::push_record(thread_buffer& p_buffer, log_data const& p_logData)
+{
 #ifdef _WIN32
 	uintptr_t const fileSize_estimate = core::UTF16_to_UTF8_faulty_size(std::u16string_view{reinterpret_cast<char16_t const*>(p_logData.file.data()), p_logData.file.size()}, '?');
 #else
 	uintptr_t const fileSize_estimate = p_logData.file.size();
 #endif
 
-	//[date]File(Line,Column) Message\n
-	uintptr_t const count =
-		p_logData.sv_date.size()
-		+ p_logData.sv_time.size()
-		+ p_logData.sv_thread.size()
+	bool const is_deferred = p_logData.deferred_message.data() != nullptr;
+
+	//|thread]File(Line,Column) Level: Message\n
+	//the [date-time prefix is rendered by the writer thread from the timestamp
+	uintptr_t const header_size =
+		p_logData.sv_thread.size()
 		+ fileSize_estimate
 		+ p_logData.sv_line.size()
 		+ (p_logData.column ? p_logData.sv_column.size() + 1 : 0) //,
-		+ p_logData.sv_level.size()
-		+ p_logData.message.size() + 10; //[-|]() : \n
+		+ p_logData.sv_level.size() + 7; //|]() : 
+
+	//deferred messages are rendered (and terminated) by the writer thread
+	uintptr_t const count = header_size +
+		(is_deferred ? p_logData.deferred_message.size() : p_logData.message_source->size() + 1);
+
+	//the size is stored in 32 bits, and is also the size class of the buffer returned to the pool
+	if(count > std::numeric_limits<uint32_t>::max())
+	{
+		return true;
+	}
+
+	record_header header;
+	header.stamp        = m_clock_source == log_clock_source::ticks ? p_logData.timestamp :
+		static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+	header.size         = static_cast<uint32_t>(count);
+	header.deferred_pos = static_cast<uint32_t>(is_deferred ? header_size : count);
+	header.level        = p_logData.level;
+
+	bool const is_external = count > p_buffer.ring->max_record_size() - sizeof(record_header);
+	uintptr_t const record_size = sizeof(record_header) + (is_external ? 0 : count);
 
-	std::vector<char8_t> buff;
-	buff.resize(count);
+	std::byte* slot;
+	while((slot = p_buffer.ring->reserve(record_size)) == nullptr)
+	{
+		//buffer is full, publish what is pending and wait for the writer thread to catch up
+		if(m_quit.load(std::memory_order::relaxed)) return false;
+		p_buffer.ring->commit();
+		wake_writer();
+		std::this_thread::yield();
+	}
+
+	char8_t* const data = is_external ? reinterpret_cast<char8_t*>(m_pool->acquire(count)) : reinterpret_cast<char8_t*>(slot + sizeof(record_header));
+	header.external = is_external ? data : nullptr;
+	memcpy(slot, &header, sizeof(record_header));
 
 	{
-		char8_t* pivot = buff.data();
-		*(pivot++) = u8'[';
-		transfer(pivot, p_logData.sv_date);
-		*(pivot++) = u8'-';
-		transfer(pivot, p_logData.sv_time);
+		char8_t* pivot = data;
 		*(pivot++) = u8'|';
 		transfer(pivot, p_logData.sv_thread);
 		*(pivot++) = u8']';
@@ -107,18 +266,44 @@ void log_async_file_sink::output(log_data const& p_logData)
 		transfer(pivot, p_logData.sv_level);
 		*(pivot++) = u8':';
 		*(pivot++) = u8' ';
-		transfer(pivot, p_logData.message);
-		*(pivot) = u8'\n';
+		if(is_deferred)
+		{
+			memcpy(pivot, p_logData.deferred_message.data(), p_logData.deferred_message.size());
+		}
+		else
+		{
+			//rendered directly into the thread buffer
+			p_logData.message_source->render(pivot);
+			pivot += p_logData.message_source->size();
+			*(pivot) = u8'\n';
+		}
 	}
+	return true;
+}
+
+bool log_async_file_sink::accepts_deferred() const
+{
+	return true;
+}
+
+log_field log_async_file_sink::required_fields() const
+{
+	//date and time are converted from the timestamp by the writer thread,
+	//the message is rendered directly into the thread buffers
+	log_field const fields = log_field::level | log_field::thread | log_field::line | log_field::column;
+	return m_clock_source == log_clock_source::ticks ? fields | log_field::timestamp : fields;
+}
 
+void log_async_file_sink::prepare_thread()
+{
+	producer_scope const scope{*this};
+	if(scope.accepted())
 	{
-		core::atomic_spinlock::scope_locker const lock{m_lock};
-		m_data.emplace(std::move(buff));
+		[[maybe_unused]] thread_buffer& buffer = get_thread_buffer();
 	}
-	m_trap.signal();
 }
 
-bool log_async_file_sink::init(std::filesystem::path const& p_fileName)
+bool log_async_file_sink::init(std::filesystem::path const& p_fileName, uintptr_t const p_thread_buffer_size)
 {
 	end();
 	bool const input_absolute = p_fileName.is_absolute();
@@ -138,27 +323,138 @@ bool log_async_file_sink::init(std::filesystem::path const& p_fileName)
 		return false;
 	}
 
+	m_id = g_sink_id.fetch_add(1, std::memory_order::relaxed) + 1;
+	m_thread_buffer_size = p_thread_buffer_size;
 	m_quit.store(false, std::memory_order::relaxed);
+	m_waiting.store(false, std::memory_order::relaxed);
 	m_trap.reset();
+	if(m_clock_source == log_clock_source::ticks)
+	{
+		m_clock.calibrate();
+	}
+	m_last_record.clear();
+	m_repeat_count = 0;
+	m_batch.resize(m_batch_size);
+	m_batch_used  = 0;
+	m_prefix_size = prefix_max_size;
+	m_flush.init(m_policy);
+	if(m_policy.sync_interval.count())
+	{
+		m_sync.open(fileName);
+	}
+	//falls back to m_file if the backends are not available
+	if(!(m_direct_config.buffer_count && m_direct.open(fileName, m_direct_config)) && m_uring_config.buffer_count)
+	{
+		m_uring.open(fileName, m_uring_config);
+	}
 	if(m_thread.create(this, &log_async_file_sink::run, nullptr) != core::thread::Error::None)
 	{
+		m_direct.close();
+		m_uring.close();
+		m_sync.close();
 		m_file.close();
 		return false;
 	}
 
+	m_accepting.store(true, std::memory_order::release);
 	return true;
 }
 
+void log_async_file_sink::set_clock_source(log_clock_source const p_source)
+{
+	m_clock_source = p_source;
+}
+
+void log_async_file_sink::set_flush_policy(log_flush_policy const& p_policy)
+{
+	m_policy = p_policy;
+}
+
+void log_async_file_sink::set_uring_backend(log_uring_config const& p_config)
+{
+	m_uring_config = p_config;
+}
+
+bool log_async_file_sink::uring_active() const
+{
+	return m_uring.is_open() && !m_uring.failed();
+}
+
+void log_async_file_sink::set_direct_io(log_direct_config const& p_config)
+{
+	m_direct_config = p_config;
+}
+
+bool log_async_file_sink::direct_active() const
+{
+	return m_direct.is_open();
+}
+
+void log_async_file_sink::set_write_batch_size(uintptr_t const p_size)
+{
+	m_batch_size = p_size;
+}
+
+void log_async_file_sink::set_repeat_suppression(std::chrono::milliseconds const p_timeout)
+{
+	m_repeat_timeout = p_timeout;
+}
+
+void log_async_file_sink::reserve_large_records(uintptr_t const p_record_size, uintptr_t const p_count)
+{
+	m_pool->reserve(p_record_size, p_count);
+}
+
 void log_async_file_sink::end()
 {
+	//the thread buffers are released below, threads still logging to the sink must leave it first
+	m_accepting.store(false, std::memory_order::seq_cst);
+	while(m_producers.load(std::memory_order::seq_cst))
+	{
+		core::yield();
+	}
+
 	if(m_thread.joinable())
 	{
 		m_quit.store(true, std::memory_order::release);
 		m_trap.signal();
 		m_thread.join();
+
+		//records committed after the last pass of the writer thread
+		while(dispatch());
+		flush_repeats();
+		flush_batch();
+	}
+
+	{
+		core::atomic_spinlock::scope_locker const lock{m_lock};
+		for(std::shared_ptr<thread_buffer> const& buffer: m_buffers)
+		{
+			//only reachable if the writer thread failed to drain them, the records are lost but not their storage
+			for(std::span<std::byte> slot = buffer->ring->front(); !slot.empty(); slot = buffer->ring->front())
+			{
+				record_header header;
+				memcpy(&header, slot.data(), sizeof(record_header));
+				if(header.external)
+				{
+					m_pool->release(reinterpret_cast<std::byte*>(header.external), header.size);
+				}
+				buffer->ring->pop();
+			}
+			buffer->ring.reset();
+			buffer->closed.store(true, std::memory_order::relaxed);
+		}
+		m_buffers.clear();
+		m_readers.clear();
+		m_readers_generation = m_generation.load(std::memory_order::relaxed);
 	}
+	m_id = 0;
 
+	m_direct.close();
+	m_uring.close();
 	m_file.flush();
+	m_sync.sync();
+	m_sync.close();
 	m_file.close();
 }
 
@@ -166,34 +462,368 @@ void log_async_file_sink::run(void*const)
 {
 	constexpr std::array UTF8_BOM = {char8_t{0xEF}, char8_t{0xBB}, char8_t{0xBF}};
 
-	m_file.write_unlocked(UTF8_BOM.data(), UTF8_BOM.size());
+	write_out(UTF8_BOM.data(), UTF8_BOM.size());
 
 	while(!m_quit.load(std::memory_order::acquire))
 	{
-		m_trap.wait();
+		if(dispatch())
+		{
+			//under sustained logging the time based flush policy is checked between passes
+			apply_flush(m_flush.on_timer(std::chrono::steady_clock::now()));
+			continue;
+		}
+
+		reclaim_buffers();
 		m_trap.reset();
-		while(!m_data.empty())
+		m_waiting.store(true, std::memory_order::seq_cst);
+		if(has_pending() || m_quit.load(std::memory_order::acquire))
 		{
-			dispatch();
+			m_waiting.store(false, std::memory_order::relaxed);
+			continue;
+		}
+
+		std::chrono::steady_clock::time_point const wake = deadline();
+		if(wake == std::chrono::steady_clock::time_point::max())
+		{
+			m_trap.wait();
+		}
+		else
+		{
+			//wake up in time to report the repetitions, or to flush the file
+			std::chrono::steady_clock::time_point const now = std::chrono::steady_clock::now();
+			if(wake > now)
+			{
+				m_trap.wait_for(std::chrono::ceil<std::chrono::milliseconds>(wake - now));
+			}
+			on_timer();
+		}
+		m_waiting.store(false, std::memory_order::relaxed);
+	}
+	while(dispatch());
+	flush_repeats();
+	flush_batch();
+}
+
+void log_async_file_sink::refresh_buffers()
+{
+	//the list only changes when a thread logs for the first time, or when the buffers of finished threads are reclaimed
+	if(m_generation.load(std::memory_order::seq_cst) == m_readers_generation)
+	{
+		return;
+	}
+
+	m_readers.clear();
+	core::atomic_spinlock::scope_locker const lock{m_lock};
+	for(std::shared_ptr<thread_buffer> const& buffer: m_buffers)
+	{
+		m_readers.push_back(buffer.get());
+	}
+	m_readers_generation = m_generation.load(std::memory_order::relaxed);
+}
+
+void log_async_file_sink::reclaim_buffers()
+{
+	core::atomic_spinlock::scope_locker const lock{m_lock};
+
+	//buffers only referenced by this sink belong to threads that no longer exist,
+	//once they have been drained they can be released
+	std::atomic_thread_fence(std::memory_order::acquire);
+	uintptr_t const removed = std::erase_if(m_buffers,
+		[](std::shared_ptr<thread_buffer> const& p_buffer)
+		{
+			return p_buffer.use_count() == 1 && p_buffer->ring->empty();
+		});
+
+	if(removed)
+	{
+		m_generation.fetch_add(1, std::memory_order::relaxed);
+	}
+}
+
+bool log_async_file_sink::has_pending() const
+{
+	core::atomic_spinlock::scope_locker const lock{m_lock};
+	for(std::shared_ptr<thread_buffer> const& buffer: m_buffers)
+	{
+		if(!buffer->ring->empty())
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+bool log_async_file_sink::dispatch()
+{
+	refresh_buffers();
+	if(m_clock_source == log_clock_source::ticks)
+	{
+		m_clock.refresh();
+	}
+
+	//a pass is bounded to about one batch, so that the writer thread gets to check m_quit and the timers
+	//even if the threads keep logging
+	uintptr_t consumed = 0;
+	bool written = false;
+	while(consumed < m_batch_size)
+	{
+		//merge the thread buffers picking the oldest record available
+		thread_buffer* next = nullptr;
+		record_header header;
+
+		for(thread_buffer* const buffer: m_readers)
+		{
+			std::span<std::byte> const slot = buffer->ring->front();
+			if(slot.empty()) continue;
+
+			uint64_t stamp;
+			memcpy(&stamp, slot.data() + offsetof(record_header, stamp), sizeof(uint64_t));
+			if(next == nullptr || stamp < header.stamp)
+			{
+				memcpy(&header, slot.data(), sizeof(record_header));
+				next = buffer;
+			}
+		}
+
+		if(next == nullptr)
+		{
+			if(repeat_expired())
+			{
+				flush_repeats();
+			}
+			flush_batch();
+			return written;
+		}
+
+		if(header.external)
+		{
+			write_record(header, header.external);
+			m_pool->release(reinterpret_cast<std::byte*>(header.external), header.size);
+		}
+		else
+		{
+			write_record(header, reinterpret_cast<char8_t const*>(next->ring->front().data() + sizeof(record_header)));
+		}
+		next->ring->pop();
+		written = true;
+		consumed += sizeof(record_header) + header.size;
+
+		//a continuous stream of repetitions is still reported on time
+		if(repeat_expired())
+		{
+			flush_repeats();
+		}
+	}
+	return true;
+}
+
+///	\brief Renders the [date-time prefix
+///	\param[out] p_out - Buffer at least prefix_max_size long
+///	\return Size of the prefix
+uintptr_t log_async_file_sink::format_prefix(uint64_t const p_stamp, char8_t* const p_out)
+{
+	core::date_time_t const time_struct = log_date_time(
+		m_clock_source == log_clock_source::ticks ?
+		m_clock.to_system_time(p_stamp) :
+		log_system_time{std::chrono::nanoseconds{p_stamp}});
+	char8_t* pivot = p_out;
+	*(pivot++) = u8'[';
+	pivot += format_log_date(time_struct, std::span<char8_t, log_date_max_size>{pivot, log_date_max_size});
+	*(pivot++) = u8'-';
+	format_log_time(time_struct, std::span<char8_t, log_time_size>{pivot, log_time_size});
+	pivot += log_time_size;
+	return pivot - p_out;
+}
+
+void log_async_file_sink::batch_reserve(uintptr_t const p_size)
+{
+	if(m_batch_used + p_size > m_batch.size())
+	{
+		flush_batch();
+		if(p_size > m_batch.size())
+		{
+			m_batch.resize(p_size);
 		}
 	}
-	dispatch();
 }
 
-void log_async_file_sink::dispatch()
+void log_async_file_sink::write_out(void const* const p_data, uintptr_t const p_size)
 {
-	std::queue<std::vector<char8_t>> local;
+	if(m_direct.is_open())
+	{
+		m_direct.write(p_data, p_size);
+	}
+	else if(m_uring.is_open())
 	{
-		core::atomic_spinlock::scope_locker lock{m_lock};
-		m_data.swap(local);
+		m_uring.write(p_data, p_size);
 	}
+	else
+	{
+		m_file.write_unlocked(p_data, p_size);
+	}
+}
 
-	while(!local.empty())
+void log_async_file_sink::flush_batch(bool const p_urgent)
+{
+	if(m_batch_used)
 	{
-		std::vector<char8_t>& obj = local.front();
-		m_file.write_unlocked(obj.data(), obj.size());
-		local.pop();
+		write_out(m_batch.data(), m_batch_used);
+		apply_flush(m_flush.on_write(m_batch_used, p_urgent, std::chrono::steady_clock::now()));
+		m_batch_used = 0;
 	}
 }
 
+void log_async_file_sink::apply_flush(_p::flush_control::action const p_action)
+{
+	if(p_action != _p::flush_control::action::none)
+	{
+		if(m_direct.is_open())
+		{
+			m_direct.flush();
+		}
+		else if(m_uring.is_open())
+		{
+			m_uring.wait_all();
+		}
+		else
+		{
+			m_file.flush_unlocked();
+		}
+		if(p_action == _p::flush_control::action::sync)
+		{
+			m_sync.sync();
+		}
+	}
+}
+
+std::chrono::steady_clock::time_point log_async_file_sink::deadline() const
+{
+	std::chrono::steady_clock::time_point const flush = m_flush.deadline();
+	if(m_repeat_count && m_repeat_since + m_repeat_timeout < flush)
+	{
+		return m_repeat_since + m_repeat_timeout;
+	}
+	return flush;
+}
+
+void log_async_file_sink::on_timer()
+{
+	if(repeat_expired())
+	{
+		flush_repeats();
+	}
+	flush_batch();
+	apply_flush(m_flush.on_timer(std::chrono::steady_clock::now()));
+}
+
+void log_async_file_sink::write_record(record_header const& p_header, char8_t const* const p_data)
+{
+	bool const is_deferred = p_header.deferred_pos != p_header.size;
+	std::span<std::byte const> const args{reinterpret_cast<std::byte const*>(p_data + p_header.deferred_pos), p_header.size - p_header.deferred_pos};
+	uintptr_t const message_size = is_deferred ? deferred_format_size(args) + 1 : 0;
+	uintptr_t const body_size = p_header.deferred_pos + message_size;
+
+	//room for the record, and the report of the repetitions of the previous one
+	batch_reserve(repeats_max_size + prefix_max_size + body_size);
+
+	//the body is rendered first, where the prefix is expected to end,
+	//the [date-time prefix is only added if the record is not a repetition
+	char8_t* start = m_batch.data() + m_batch_used + m_prefix_size;
+	char8_t* pivot = start;
+
+	memcpy(pivot, p_data, p_header.deferred_pos);
+	pivot += p_header.deferred_pos;
+
+	if(is_deferred)
+	{
+		deferred_format(args, pivot);
+		pivot += message_size - 1;
+		*(pivot++) = u8'\n';
+	}
+
+	if(m_repeat_timeout.count())
+	{
+		//|thread]File(Line,Column) Level: Message\n, the thread is not relevant
+		uintptr_t const content_pos = std::u8string_view{start, body_size}.find(u8']') + 1;
+
+		if(std::u8string_view{start + content_pos, body_size - content_pos} == m_last_record)
+		{
+			if(m_repeat_count++ == 0)
+			{
+				m_repeat_since = std::chrono::steady_clock::now();
+			}
+			m_repeat_stamp = p_header.stamp;
+
+			//a repeated error is still flushed right away, with the repetitions so far
+			if(p_header.level == Level::Error && m_flush.policy().flush_on_error)
+			{
+				flush_repeats();
+				flush_batch(true);
+			}
+			return;
+		}
+
+		if(m_repeat_count)
+		{
+			//the report of the repetitions goes before the record
+			std::array<char8_t, repeats_max_size> line;
+			uintptr_t const line_size = format_repeats(line.data());
+			memmove(start + line_size, start, body_size);
+			memcpy(m_batch.data() + m_batch_used, line.data(), line_size);
+			m_batch_used += line_size;
+			start += line_size;
+		}
+		m_last_record.assign(start + content_pos, body_size - content_pos);
+	}
+
+	std::array<char8_t, prefix_max_size> prefix;
+	uintptr_t const prefix_size = format_prefix(p_header.stamp, prefix.data());
+	if(prefix_size != m_prefix_size)
+	{
+		memmove(m_batch.data() + m_batch_used + prefix_size, start, body_size);
+		m_prefix_size = prefix_size;
+	}
+	memcpy(m_batch.data() + m_batch_used, prefix.data(), prefix_size);
+	m_batch_used += prefix_size + body_size;
+
+	if(p_header.level == Level::Error && m_flush.policy().flush_on_error)
+	{
+		flush_batch(true);
+	}
+	else if(m_batch_used >= m_batch_size)
+	{
+		flush_batch();
+	}
+}
+
+bool log_async_file_sink::repeat_expired() const
+{
+	return m_repeat_count && std::chrono::steady_clock::now() - m_repeat_since >= m_repeat_timeout;
+}
+
+///	\brief Renders the line reporting the repetitions of the last record
+///	\param[out] p_out - Buffer at least repeats_max_size long
+///	\return Size of the line
+uintptr_t log_async_file_sink::format_repeats(char8_t* const p_out)
+{
+	char8_t* pivot = p_out + format_prefix(m_repeat_stamp, p_out);
+	transfer(pivot, repeats_intro);
+	pivot += core::to_chars(m_repeat_count, std::span<char8_t, repeats_count_max_size>{pivot, repeats_count_max_size});
+	transfer(pivot, repeats_outro);
+
+	m_repeat_count = 0;
+	return pivot - p_out;
+}
+
+void log_async_file_sink::flush_repeats()
+{
+	if(m_repeat_count == 0)
+	{
+		return;
+	}
+
+	batch_reserve(repeats_max_size);
+	m_batch_used += format_repeats(m_batch.data() + m_batch_used);
+}
+
 } //namespace simLog
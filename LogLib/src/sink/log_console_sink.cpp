@@ -27,33 +27,39 @@
 
 #include <LogLib/sink/log_console_sink.hpp>
 
-#include <vector>
-
 #include <CoreLib/core_console.hpp>
 #include <CoreLib/string/core_string_encoding.hpp>
 #include <CoreLib/core_alloca.hpp>
 #include <CoreLib/core_extra_compiler.hpp>
 
+#include <LogLib/log_scratch.hpp>
+
 namespace logger
 {
 
 log_console_sink::log_console_sink() = default;
 
+log_field log_console_sink::required_fields() const
+{
+	return log_field::level | log_field::message;
+}
+
 
-static void finish_cout(std::u8string_view const p_level, std::u8string_view const p_message, char8_t* p_buffer, uintptr_t const p_size, bool const p_printLevel)
+static void finish_cout(std::u8string_view const p_level, std::u8string_view const p_message, char8_t* const p_buffer, uintptr_t const p_size, bool const p_printLevel)
 {
+	char8_t* pivot = p_buffer;
 	if(p_printLevel)
 	{
 		uintptr_t const lsize = p_level.size();
-		memcpy(p_buffer, p_level.data(), lsize);
-		p_buffer += lsize;
-		*(p_buffer++) = u8':';
-		*(p_buffer++) = u8' ';
+		memcpy(pivot, p_level.data(), lsize);
+		pivot += lsize;
+		*(pivot++) = u8':';
+		*(pivot++) = u8' ';
 	}
 	uintptr_t const msize = p_message.size();
-	memcpy(p_buffer, p_message.data(), msize);
-	p_buffer += msize;
-	*p_buffer = u8'\n';
+	memcpy(pivot, p_message.data(), msize);
+	pivot += msize;
+	*pivot = u8'\n';
 	core::cout.write(std::u8string_view{p_buffer, p_size});
 }
 
@@ -68,8 +74,7 @@ NO_INLINE void log_console_sink::output(log_data const& p_logData)
 
 	if(char_count > alloca_treshold)
 	{
-		std::vector<char8_t> buff;
-		buff.resize(char_count);
+		log_scratch<char8_t> const buff{char_count};
 		finish_cout(p_logData.sv_level, p_logData.message, buff.data(), char_count, print_level);
 	}
 	else
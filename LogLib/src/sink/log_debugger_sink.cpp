@@ -32,12 +32,13 @@
 #include <Windows.h>
 
 #include <string_view>
-#include <vector>
 
 #include <CoreLib/string/core_string_encoding.hpp>
 #include <CoreLib/core_alloca.hpp>
 #include <CoreLib/core_extra_compiler.hpp>
 
+#include <LogLib/log_scratch.hpp>
+
 namespace logger
 {
 
@@ -94,6 +95,11 @@ static inline void AuxWriteData(
 
 log_debugger_sink::log_debugger_sink() = default;
 
+log_field log_debugger_sink::required_fields() const
+{
+	return log_field::level | log_field::time | log_field::thread | log_field::line | log_field::column | log_field::message;
+}
+
 NO_INLINE void log_debugger_sink::output(log_data const& p_logData)
 {
 	if(IsDebuggerPresent())
@@ -119,8 +125,7 @@ NO_INLINE void log_debugger_sink::output(log_data const& p_logData)
 
 		if(count > alloca_treshold)
 		{
-			std::vector<char16_t> buff;
-			buff.resize(count);
+			log_scratch<char16_t> const buff{count};
 			AuxWriteData(p_logData, buff.data(),
 				line_estimate, col_estimate,
 				time_estimate, thread_estimate,
@@ -0,0 +1,441 @@
+//======== ======== ======== ======== ======== ======== ======== ========
+///	\file
+///
+///	\copyright
+///		Copyright (c) Tiago Miguel Oliveira Freire
+///
+///		Permission is hereby granted, free of charge, to any person obtaining a copy
+///		of this software and associated documentation files (the "Software"),
+///		to copy, modify, publish, and/or distribute copies of the Software,
+///		and to permit persons to whom the Software is furnished to do so,
+///		subject to the following conditions:
+///
+///		The copyright notice and this permission notice shall be included in all
+///		copies or substantial portions of the Software.
+///		The copyrighted work, or derived works, shall not be used to train
+///		Artificial Intelligence models of any sort; or otherwise be used in a
+///		transformative way that could obfuscate the source of the copyright.
+///
+///		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+///		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+///		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+///		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+///		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+///		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+///		SOFTWARE.
+//======== ======== ======== ======== ======== ======== ======== ========
+
+
+#include <LogLib/sink/log_direct_writer.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include <CoreLib/core_thread.hpp>
+
+#ifdef _WIN32
+#	include <Windows.h>
+#else
+#	include <fcntl.h>
+#	include <unistd.h>
+#	include <sys/stat.h>
+#endif
+
+namespace logger::_p
+{
+
+static constexpr uintptr_t default_alignment = 4096;
+
+//======== ======== ======== ======== Platform ======== ======== ======== ========
+
+#ifdef _WIN32
+
+using native_handle = HANDLE;
+static native_handle const invalid_handle = INVALID_HANDLE_VALUE;
+
+static native_handle open_direct(std::filesystem::path const& p_fileName)
+{
+	return CreateFileW(p_fileName.native().c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+		nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_NO_BUFFERING, nullptr);
+}
+
+static uintptr_t query_alignment(native_handle)
+{
+	return default_alignment;
+}
+
+static bool file_size(native_handle const p_handle, uint64_t& p_size)
+{
+	LARGE_INTEGER size;
+	if(!GetFileSizeEx(p_handle, &size))
+	{
+		return false;
+	}
+	p_size = static_cast<uint64_t>(size.QuadPart);
+	return true;
+}
+
+static intptr_t write_at(native_handle const p_handle, void const* const p_data, uintptr_t const p_size, uint64_t const p_offset)
+{
+	OVERLAPPED position{};
+	position.Offset     = static_cast<DWORD>(p_offset);
+	position.OffsetHigh = static_cast<DWORD>(p_offset >> 32);
+	DWORD written = 0;
+	if(!WriteFile(p_handle, p_data, static_cast<DWORD>(std::min<uintptr_t>(p_size, 0x80000000)), &written, &position))
+	{
+		return -1;
+	}
+	return static_cast<intptr_t>(written);
+}
+
+static intptr_t read_at(native_handle const p_handle, void* const p_data, uintptr_t const p_size, uint64_t const p_offset)
+{
+	OVERLAPPED position{};
+	position.Offset     = static_cast<DWORD>(p_offset);
+	position.OffsetHigh = static_cast<DWORD>(p_offset >> 32);
+	DWORD read = 0;
+	if(!ReadFile(p_handle, p_data, static_cast<DWORD>(p_size), &read, &position))
+	{
+		return -1;
+	}
+	return static_cast<intptr_t>(read);
+}
+
+static void truncate_file(native_handle const p_handle, uint64_t const p_size)
+{
+	FILE_END_OF_FILE_INFO info;
+	info.EndOfFile.QuadPart = static_cast<LONGLONG>(p_size);
+	SetFileInformationByHandle(p_handle, FileEndOfFileInfo, &info, sizeof(info));
+}
+
+static void close_file(native_handle const p_handle)
+{
+	CloseHandle(p_handle);
+}
+
+#else
+
+using native_handle = int;
+static constexpr native_handle invalid_handle = -1;
+
+static native_handle open_direct(std::filesystem::path const& p_fileName)
+{
+#if defined(O_DIRECT)
+	//fails if the file system does not support direct I/O, the sinks then use their other backends
+	return ::open(p_fileName.c_str(), O_RDWR | O_CLOEXEC | O_DIRECT);
+#else
+	native_handle const handle = ::open(p_fileName.c_str(), O_RDWR | O_CLOEXEC);
+#	if defined(F_NOCACHE)
+	if(handle != -1)
+	{
+		fcntl(handle, F_NOCACHE, 1);
+	}
+#	endif
+	return handle;
+#endif
+}
+
+static uintptr_t query_alignment([[maybe_unused]] native_handle const p_handle)
+{
+#if defined(STATX_DIOALIGN)
+	struct statx info;
+	if(statx(p_handle, "", AT_EMPTY_PATH, STATX_DIOALIGN, &info) == 0 && (info.stx_mask & STATX_DIOALIGN) && info.stx_dio_offset_align)
+	{
+		return std::max<uintptr_t>(info.stx_dio_offset_align, info.stx_dio_mem_align);
+	}
+#endif
+	return default_alignment;
+}
+
+static bool file_size(native_handle const p_handle, uint64_t& p_size)
+{
+	struct stat info;
+	if(fstat(p_handle, &info) != 0)
+	{
+		return false;
+	}
+	p_size = static_cast<uint64_t>(info.st_size);
+	return true;
+}
+
+static intptr_t write_at(native_handle const p_handle, void const* const p_data, uintptr_t const p_size, uint64_t const p_offset)
+{
+	return pwrite(p_handle, p_data, p_size, static_cast<off_t>(p_offset));
+}
+
+static intptr_t read_at(native_handle const p_handle, void* const p_data, uintptr_t const p_size, uint64_t const p_offset)
+{
+	return pread(p_handle, p_data, p_size, static_cast<off_t>(p_offset));
+}
+
+static void truncate_file(native_handle const p_handle, uint64_t const p_size)
+{
+	[[maybe_unused]] int const res = ftruncate(p_handle, static_cast<off_t>(p_size));
+}
+
+static void close_file(native_handle const p_handle)
+{
+	::close(p_handle);
+}
+
+#endif
+
+static void write_all(native_handle const p_handle, char8_t const* p_data, uintptr_t p_size, uint64_t p_offset)
+{
+	while(p_size)
+	{
+		intptr_t const res = write_at(p_handle, p_data, p_size, p_offset);
+		if(res <= 0)
+		{
+			return;
+		}
+		p_data   += res;
+		p_size   -= static_cast<uintptr_t>(res);
+		p_offset += static_cast<uint64_t>(res);
+	}
+}
+
+static inline uintptr_t align_down(uint64_t const p_value, uintptr_t const p_alignment)
+{
+	return static_cast<uintptr_t>(p_value & ~static_cast<uint64_t>(p_alignment - 1));
+}
+
+static inline uintptr_t align_up(uintptr_t const p_value, uintptr_t const p_alignment)
+{
+	return (p_value + p_alignment - 1) & ~(p_alignment - 1);
+}
+
+//======== ======== ======== ======== direct_writer ======== ======== ======== ========
+
+struct direct_writer::file
+{
+	struct job
+	{
+		uint32_t  index;
+		uint64_t  offset;
+		uintptr_t size;
+	};
+
+	~file()
+	{
+		if(thread.joinable())
+		{
+			{
+				std::scoped_lock const lock{mutex};
+				quit = true;
+			}
+			work_ready.notify_one();
+			thread.join();
+		}
+		for(char8_t* const buffer: buffers)
+		{
+			::operator delete(buffer, std::align_val_t{alignment});
+		}
+		if(handle != invalid_handle)
+		{
+			close_file(handle);
+		}
+	}
+
+	bool init(std::filesystem::path const& p_fileName, log_direct_config const& p_config)
+	{
+		if(p_config.buffer_count == 0)
+		{
+			return false;
+		}
+
+		handle = open_direct(p_fileName);
+		if(handle == invalid_handle)
+		{
+			return false;
+		}
+
+		alignment = p_config.alignment ? p_config.alignment : query_alignment(handle);
+		if(alignment & (alignment - 1))
+		{
+			return false;
+		}
+		buffer_size  = align_up(std::max(p_config.buffer_size, alignment), alignment);
+		buffer_count = std::max<uint32_t>(p_config.buffer_count, 2);
+
+		buffers.reserve(buffer_count);
+		for(uint32_t i = 0; i < buffer_count; ++i)
+		{
+			buffers.push_back(static_cast<char8_t*>(::operator new(buffer_size, std::align_val_t{alignment})));
+		}
+		for(uint32_t i = buffer_count; --i;)
+		{
+			free.push_back(i);
+		}
+		fill = 0;
+
+		//writes must start at an aligned position, the last partial block is read back into the buffer
+		uint64_t size;
+		if(!file_size(handle, size))
+		{
+			return false;
+		}
+		offset = align_down(size, alignment);
+		used   = static_cast<uintptr_t>(size - offset);
+		if(used && read_at(handle, buffers[fill], alignment, offset) < static_cast<intptr_t>(used))
+		{
+			return false;
+		}
+
+		return thread.create(this, &file::run, nullptr) == core::thread::Error::None;
+	}
+
+	void run(void*)
+	{
+		std::unique_lock lock{mutex};
+		while(true)
+		{
+			work_ready.wait(lock, [this] { return quit || !jobs.empty(); });
+			if(jobs.empty())
+			{
+				return;
+			}
+			job const current = jobs.front();
+			jobs.pop_front();
+			busy = true;
+			lock.unlock();
+
+			write_all(handle, buffers[current.index], current.size, current.offset);
+
+			lock.lock();
+			busy = false;
+			free.push_back(current.index);
+			buffer_ready.notify_all();
+		}
+	}
+
+	void write(char8_t const* p_data, uintptr_t p_size)
+	{
+		while(p_size)
+		{
+			uintptr_t const size = std::min(p_size, buffer_size - used);
+			memcpy(buffers[fill] + used, p_data, size);
+			used   += size;
+			p_data += size;
+			p_size -= size;
+			if(used == buffer_size)
+			{
+				swap_buffer();
+			}
+		}
+	}
+
+	///	\brief Hands the full buffer to the background thread and continues on a free one
+	void swap_buffer()
+	{
+		std::unique_lock lock{mutex};
+		jobs.push_back(job{.index = fill, .offset = offset, .size = buffer_size});
+		work_ready.notify_one();
+		offset += buffer_size;
+		used = 0;
+
+		buffer_ready.wait(lock, [this] { return !free.empty(); });
+		fill = free.back();
+		free.pop_back();
+	}
+
+	void flush()
+	{
+		{
+			std::unique_lock lock{mutex};
+			buffer_ready.wait(lock, [this] { return jobs.empty() && !busy; });
+		}
+
+		if(used)
+		{
+			//the tail is padded to a full block, and kept in the buffer to be rewritten once more data arrives
+			char8_t* const buffer = buffers[fill];
+			uintptr_t const padded = align_up(used, alignment);
+			memset(buffer + used, 0, padded - used);
+			write_all(handle, buffer, padded, offset);
+
+			uintptr_t const complete = align_down(used, alignment);
+			if(complete)
+			{
+				memmove(buffer, buffer + complete, used - complete);
+				offset += complete;
+				used   -= complete;
+			}
+		}
+	}
+
+	void close()
+	{
+		flush();
+		truncate_file(handle, offset + used);
+	}
+
+	native_handle handle = invalid_handle;
+	uintptr_t alignment    = default_alignment;
+	uintptr_t buffer_size  = 0;
+	uint32_t  buffer_count = 0;
+	std::vector<char8_t*> buffers;
+
+	//writer only
+	uint32_t  fill   = 0; //!< Buffer being filled
+	uintptr_t used   = 0;
+	uint64_t  offset = 0; //!< Position of the buffer being filled in the file
+
+	//shared with the background thread
+	std::mutex mutex;
+	std::condition_variable work_ready;
+	std::condition_variable buffer_ready;
+	std::deque<job> jobs;
+	std::vector<uint32_t> free;
+	bool busy = false;
+	bool quit = false;
+	core::thread thread;
+};
+
+direct_writer::direct_writer() = default;
+
+direct_writer::~direct_writer()
+{
+	close();
+}
+
+bool direct_writer::open(std::filesystem::path const& p_fileName, log_direct_config const& p_config)
+{
+	close();
+	std::unique_ptr<file> temp = std::make_unique<file>();
+	if(!temp->init(p_fileName, p_config))
+	{
+		return false;
+	}
+	m_file = std::move(temp);
+	return true;
+}
+
+void direct_writer::close()
+{
+	if(m_file)
+	{
+		m_file->close();
+		m_file.reset();
+	}
+}
+
+void direct_writer::write(void const* const p_data, uintptr_t const p_size)
+{
+	m_file->write(static_cast<char8_t const*>(p_data), p_size);
+}
+
+void direct_writer::flush()
+{
+	if(m_file)
+	{
+		m_file->flush();
+	}
+}
+
+} //namespace logger::_p
@@ -29,71 +29,15 @@
 
 #include <array>
 #include <cstdio>
-#include <vector>
 #include <utility>
 
-#include <CoreLib/string/core_string_encoding.hpp>
 #include <CoreLib/core_alloca.hpp>
 
-namespace logger
-{
-
-static inline void transfer(char8_t*& p_buff, std::u8string_view const p_str)
-{
-	memcpy(p_buff, p_str.data(), p_str.size());
-	p_buff += p_str.size();
-}
+#include <LogLib/log_scratch.hpp>
+#include <LogLib/sink/log_file_format.hpp>
 
-#ifdef _WIN32
-#	define AUX_WRITE_DATA(STREAM, DATA, BUFFER, SIZE, FILE_SIZE) AuxWriteData(STREAM, DATA, BUFFER, SIZE, FILE_SIZE)
-#else
-#	define AUX_WRITE_DATA(STREAM, DATA, BUFFER, SIZE, FILE_SIZE) AuxWriteData(STREAM, DATA, BUFFER, SIZE)
-#endif
-
-static inline void
-	AUX_WRITE_DATA(core::file_write& p_file,
-		log_data const& p_logData,
-		char8_t* const  p_buffer,
-		uintptr_t const p_buffer_size,
-		uintptr_t const p_fileName_size)
+namespace logger
 {
-	char8_t* pivot = p_buffer;
-	*(pivot++) = u8'[';
-	transfer(pivot, p_logData.sv_date);
-	*(pivot++) = u8'-';
-	transfer(pivot, p_logData.sv_time);
-	*(pivot++) = u8'|';
-	transfer(pivot, p_logData.sv_thread);
-	*(pivot++) = u8']';
-
-#ifdef _WIN32
-	core::UTF16_to_UTF8_faulty_unsafe(std::u16string_view{reinterpret_cast<char16_t const*>(p_logData.file.data()), p_logData.file.size()}, '?', pivot);
-	pivot += p_fileName_size;
-#else
-	memcpy(pivot, p_logData.file.data(), p_logData.file.size());
-	pivot += p_logData.file.size();
-#endif
-
-	*(pivot++) = u8'(';
-	transfer(pivot, p_logData.sv_line);
-
-	if(p_logData.column)
-	{
-		*(pivot++) = u8',';
-		transfer(pivot, p_logData.sv_column);
-	}
-	*(pivot++) = u8')';
-	*(pivot++) = u8' ';
-	transfer(pivot, p_logData.sv_level);
-	*(pivot++) = u8':';
-	*(pivot++) = u8' ';
-	transfer(pivot, p_logData.message);
-	*(pivot) = u8'\n';
-
-	p_file.write(p_buffer, p_buffer_size);
-}
-
-
 
 log_file_sink::log_file_sink() = default;
 
@@ -102,43 +46,133 @@ log_file_sink::~log_file_sink()
 	end();
 }
 
+log_field log_file_sink::required_fields() const
+{
+	//the message is rendered directly into the write buffer
+	return log_field::level | log_field::date | log_field::time | log_field::thread | log_field::line | log_field::column;
+}
 
 void log_file_sink::output(log_data const& p_logData)
 {
 	if(!m_file.is_open()) return;
 
-#ifdef _WIN32
-	uintptr_t const fileSize_estimate = core::UTF16_to_UTF8_faulty_size(std::u16string_view{reinterpret_cast<char16_t const*>(p_logData.file.data()), p_logData.file.size()}, '?');
-#else
-	uintptr_t const fileSize_estimate = p_logData.file.size();
-#endif
-
-	//[date]File(Line,Column) Message\n
-	uintptr_t const count =
-		p_logData.sv_date.size()
-		+ p_logData.sv_time.size()
-		+ p_logData.sv_thread.size()
-		+ fileSize_estimate
-		+ p_logData.sv_line.size()
-		+ (p_logData.column ? p_logData.sv_column.size() + 1 : 0) //,
-		+ p_logData.sv_level.size()
-		+ p_logData.message.size() + 10; //[-|]() : \n
+	uintptr_t const fileSize_estimate = _p::file_record_name_size(p_logData);
+	uintptr_t const count = _p::file_record_size(p_logData, fileSize_estimate);
 
 	constexpr uintptr_t alloca_treshold = 0x10000;
 
 	if(count > alloca_treshold)
 	{
-		std::vector<char8_t> buff;
-		buff.resize(count);
-		AUX_WRITE_DATA(m_file, p_logData, buff.data(), count, fileSize_estimate);
+		log_scratch<char8_t> const buff{count};
+		_p::file_record_write(p_logData, buff.data(), fileSize_estimate);
+		write_out(buff.data(), count);
 	}
 	else
 	{
 		char8_t* buff = reinterpret_cast<char8_t*>(core_alloca(count));
-		AUX_WRITE_DATA(m_file, p_logData, buff, count, fileSize_estimate);
+		_p::file_record_write(p_logData, buff, fileSize_estimate);
+		write_out(buff, count);
+	}
+	written(count, p_logData.level == Level::Error);
+}
+
+void log_file_sink::output_batch(std::span<log_data const> const p_records)
+{
+	if(!m_file.is_open()) return;
+
+	//the whole batch is written at once
+	uintptr_t count = 0;
+	bool urgent = false;
+	for(log_data const& record: p_records)
+	{
+		count += _p::file_record_size(record, _p::file_record_name_size(record));
+		urgent |= record.level == Level::Error;
+	}
+
+	log_scratch<char8_t> const buff{count};
+	char8_t* pivot = buff.data();
+	for(log_data const& record: p_records)
+	{
+		pivot = _p::file_record_write(record, pivot, _p::file_record_name_size(record));
+	}
+	write_out(buff.data(), count);
+	written(count, urgent);
+}
+
+void log_file_sink::write_out(void const* const p_data, uintptr_t const p_size)
+{
+	if(m_direct.is_open())
+	{
+		std::scoped_lock const lock{m_backend_lock};
+		m_direct.write(p_data, p_size);
+	}
+	else if(m_uring.is_open())
+	{
+		std::scoped_lock const lock{m_backend_lock};
+		m_uring.write(p_data, p_size);
+	}
+	else
+	{
+		m_file.write(p_data, p_size);
+	}
+}
+
+void log_file_sink::written(uintptr_t const p_bytes, bool const p_urgent)
+{
+	_p::flush_control::action action;
+	{
+		core::atomic_spinlock::scope_locker const lock{m_flush_lock};
+		action = m_flush.on_write(p_bytes, p_urgent, _p::flush_control::clock::now());
+	}
+
+	if(action != _p::flush_control::action::none)
+	{
+		if(m_direct.is_open())
+		{
+			std::scoped_lock const lock{m_backend_lock};
+			m_direct.flush();
+		}
+		else if(m_uring.is_open())
+		{
+			std::scoped_lock const lock{m_backend_lock};
+			m_uring.wait_all();
+		}
+		else
+		{
+			m_file.flush();
+		}
+		if(action == _p::flush_control::action::sync)
+		{
+			m_sync.sync();
+		}
 	}
 }
 
+void log_file_sink::set_flush_policy(log_flush_policy const& p_policy)
+{
+	m_policy = p_policy;
+}
+
+void log_file_sink::set_uring_backend(log_uring_config const& p_config)
+{
+	m_uring_config = p_config;
+}
+
+bool log_file_sink::uring_active() const
+{
+	return m_uring.is_open() && !m_uring.failed();
+}
+
+void log_file_sink::set_direct_io(log_direct_config const& p_config)
+{
+	m_direct_config = p_config;
+}
+
+bool log_file_sink::direct_active() const
+{
+	return m_direct.is_open();
+}
+
 bool log_file_sink::init(std::filesystem::path const& p_fileName)
 {
 	end();
@@ -163,13 +197,29 @@ bool log_file_sink::init(std::filesystem::path const& p_fileName)
 
 	constexpr std::array UTF8_BOM = {char8_t{0xEF}, char8_t{0xBB}, char8_t{0xBF}};
 
-	m_file.write(UTF8_BOM.data(), UTF8_BOM.size());
+	//falls back to m_file if the backends are not available
+	if(!(m_direct_config.buffer_count && m_direct.open(fileName, m_direct_config)) && m_uring_config.buffer_count)
+	{
+		m_uring.open(fileName, m_uring_config);
+	}
+
+	write_out(UTF8_BOM.data(), UTF8_BOM.size());
+
+	m_flush.init(m_policy);
+	if(m_policy.sync_interval.count())
+	{
+		m_sync.open(fileName);
+	}
 	return true;
 }
 
 void log_file_sink::end()
 {
+	m_direct.close();
+	m_uring.close();
 	m_file.flush();
+	m_sync.sync();
+	m_sync.close();
 	m_file.close();
 }
 
@@ -0,0 +1,204 @@
+//======== ======== ======== ======== ======== ======== ======== ========
+///	\file
+///
+///	\copyright
+///		Copyright (c) Tiago Miguel Oliveira Freire
+///
+///		Permission is hereby granted, free of charge, to any person obtaining a copy
+///		of this software and associated documentation files (the "Software"),
+///		to copy, modify, publish, and/or distribute copies of the Software,
+///		and to permit persons to whom the Software is furnished to do so,
+///		subject to the following conditions:
+///
+///		The copyright notice and this permission notice shall be included in all
+///		copies or substantial portions of the Software.
+///		The copyrighted work, or derived works, shall not be used to train
+///		Artificial Intelligence models of any sort; or otherwise be used in a
+///		transformative way that could obfuscate the source of the copyright.
+///
+///		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+///		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+///		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+///		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+///		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+///		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+///		SOFTWARE.
+//======== ======== ======== ======== ======== ======== ======== ========
+
+
+#include <LogLib/sink/log_flight_recorder_sink.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+#include <LogLib/log_flight_recorder.hpp>
+#include <LogLib/log_scratch.hpp>
+#include <LogLib/sink/log_file_format.hpp>
+
+#ifdef _WIN32
+#	include <Windows.h>
+#else
+#	include <fcntl.h>
+#	include <unistd.h>
+#	include <sys/mman.h>
+#endif
+
+namespace logger
+{
+
+static constexpr uintptr_t ring_alignment = 0x1000;
+
+log_flight_recorder_sink::log_flight_recorder_sink() = default;
+
+log_flight_recorder_sink::~log_flight_recorder_sink()
+{
+	end();
+}
+
+log_field log_flight_recorder_sink::required_fields() const
+{
+	//the message is rendered directly into the ring
+	return log_field::level | log_field::date | log_field::time | log_field::thread | log_field::line | log_field::column;
+}
+
+void log_flight_recorder_sink::output(log_data const& p_logData)
+{
+	if(!m_ring) return;
+
+	uintptr_t const fileName_size = _p::file_record_name_size(p_logData);
+	uintptr_t const size = _p::file_record_size(p_logData, fileName_size);
+	uint32_t  const stored = static_cast<uint32_t>(std::min(size, m_ring_size / 2 - sizeof(_p::flight_record_header)));
+
+	uint64_t const position = std::atomic_ref<uint64_t>{*m_head}.fetch_add(_p::flight_record_span(stored), std::memory_order::relaxed);
+
+	_p::flight_record_header& header = *reinterpret_cast<_p::flight_record_header*>(m_ring + position % m_ring_size);
+	header.position = position;
+	header.size     = stored;
+
+	uint64_t  const text  = position + sizeof(_p::flight_record_header);
+	uintptr_t const start = static_cast<uintptr_t>(text % m_ring_size);
+	if(stored == size && start + size <= m_ring_size)
+	{
+		_p::file_record_write(p_logData, m_ring + start, fileName_size);
+	}
+	else
+	{
+		//wraps around the ring, or is truncated
+		log_scratch<char8_t> const buff{size};
+		_p::file_record_write(p_logData, buff.data(), fileName_size);
+		buff.data()[stored - 1] = u8'\n';
+		copy(text, buff.data(), stored);
+	}
+
+	std::atomic_ref<uint32_t>{header.commit}.store(_p::flight_record_commit(position, stored), std::memory_order::release);
+}
+
+void log_flight_recorder_sink::copy(uint64_t const p_position, char8_t const* const p_data, uintptr_t const p_size)
+{
+	uintptr_t const start = static_cast<uintptr_t>(p_position % m_ring_size);
+	uintptr_t const first = std::min(p_size, m_ring_size - start);
+	memcpy(m_ring + start, p_data, first);
+	memcpy(m_ring, p_data + first, p_size - first);
+}
+
+bool log_flight_recorder_sink::init(std::filesystem::path const& p_fileName, uintptr_t const p_ring_size)
+{
+	end();
+
+	uintptr_t const ring_size = (std::max<uintptr_t>(p_ring_size, 1) + ring_alignment - 1) & ~(ring_alignment - 1);
+	uintptr_t const view_size = sizeof(_p::flight_recorder_header) + ring_size;
+
+#ifdef _WIN32
+	HANDLE const file = CreateFileW(p_fileName.native().c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if(file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+	m_file = file;
+
+	uint64_t const file_size = view_size;
+	m_mapping = CreateFileMappingW(file, nullptr, PAGE_READWRITE, static_cast<DWORD>(file_size >> 32), static_cast<DWORD>(file_size), nullptr);
+	if(!m_mapping)
+	{
+		end();
+		return false;
+	}
+	m_view = MapViewOfFile(m_mapping, FILE_MAP_WRITE, 0, 0, view_size);
+	if(!m_view)
+	{
+		end();
+		return false;
+	}
+#else
+	int const file = ::open(p_fileName.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if(file == -1)
+	{
+		return false;
+	}
+	m_file = file;
+
+	if(ftruncate(file, static_cast<off_t>(view_size)) != 0)
+	{
+		end();
+		return false;
+	}
+	void* const view = mmap(nullptr, view_size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+	if(view == MAP_FAILED)
+	{
+		end();
+		return false;
+	}
+	m_view = view;
+#endif
+
+	m_view_size = view_size;
+	_p::flight_recorder_header& header = *static_cast<_p::flight_recorder_header*>(m_view);
+	memcpy(header.magic, _p::flight_recorder_magic, sizeof(header.magic));
+	header.ring_size = ring_size;
+	header.head = 0;
+
+	m_head = &header.head;
+	m_ring = static_cast<char8_t*>(m_view) + sizeof(_p::flight_recorder_header);
+	m_ring_size = ring_size;
+	return true;
+}
+
+void log_flight_recorder_sink::end()
+{
+	m_ring = nullptr;
+	m_head = nullptr;
+	m_ring_size = 0;
+
+#ifdef _WIN32
+	if(m_view)
+	{
+		UnmapViewOfFile(m_view);
+		m_view = nullptr;
+	}
+	if(m_mapping)
+	{
+		CloseHandle(m_mapping);
+		m_mapping = nullptr;
+	}
+	if(m_file)
+	{
+		CloseHandle(m_file);
+		m_file = nullptr;
+	}
+#else
+	if(m_view)
+	{
+		munmap(m_view, m_view_size);
+		m_view = nullptr;
+	}
+	if(m_file != -1)
+	{
+		::close(m_file);
+		m_file = -1;
+	}
+#endif
+	m_view_size = 0;
+}
+
+} //namespace simLog
@@ -0,0 +1,187 @@
+//======== ======== ======== ======== ======== ======== ======== ========
+///	\file
+///
+///	\copyright
+///		Copyright (c) Tiago Miguel Oliveira Freire
+///
+///		Permission is hereby granted, free of charge, to any person obtaining a copy
+///		of this software and associated documentation files (the "Software"),
+///		to copy, modify, publish, and/or distribute copies of the Software,
+///		and to permit persons to whom the Software is furnished to do so,
+///		subject to the following conditions:
+///
+///		The copyright notice and this permission notice shall be included in all
+///		copies or substantial portions of the Software.
+///		The copyrighted work, or derived works, shall not be used to train
+///		Artificial Intelligence models of any sort; or otherwise be used in a
+///		transformative way that could obfuscate the source of the copyright.
+///
+///		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+///		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+///		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+///		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+///		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+///		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+///		SOFTWARE.
+//======== ======== ======== ======== ======== ======== ======== ========
+
+
+#include <LogLib/sink/log_flush_policy.hpp>
+
+#ifdef _WIN32
+#	include <Windows.h>
+#else
+#	include <fcntl.h>
+#	include <unistd.h>
+#endif
+
+namespace logger::_p
+{
+
+void flush_control::init(log_flush_policy const& p_policy)
+{
+	m_policy = p_policy;
+	m_unflushed = 0;
+	m_unsynced = false;
+	m_last_sync = clock::now();
+}
+
+flush_control::action flush_control::take_flush(bool const p_urgent, clock::time_point const p_now)
+{
+	m_unflushed = 0;
+	if(m_policy.sync_interval.count() && (p_urgent || p_now - m_last_sync >= m_policy.sync_interval))
+	{
+		m_unsynced = false;
+		m_last_sync = p_now;
+		return action::sync;
+	}
+	m_unsynced = true;
+	return action::flush;
+}
+
+flush_control::action flush_control::on_write(uintptr_t const p_bytes, bool const p_urgent, clock::time_point const p_now)
+{
+	if(m_unflushed == 0)
+	{
+		m_unflushed_since = p_now;
+	}
+	m_unflushed += p_bytes;
+
+	if(m_unflushed == 0)
+	{
+		return action::none;
+	}
+
+	bool const urgent = p_urgent && m_policy.flush_on_error;
+	if(urgent
+		|| (m_policy.flush_bytes && m_unflushed >= m_policy.flush_bytes)
+		|| (m_policy.flush_interval.count() && p_now - m_unflushed_since >= m_policy.flush_interval)
+		|| (m_policy.sync_interval.count() && p_now - m_last_sync >= m_policy.sync_interval))
+	{
+		return take_flush(urgent, p_now);
+	}
+	return action::none;
+}
+
+flush_control::action flush_control::on_timer(clock::time_point const p_now)
+{
+	if(m_unflushed)
+	{
+		if((m_policy.flush_interval.count() && p_now - m_unflushed_since >= m_policy.flush_interval)
+			|| (m_policy.sync_interval.count() && p_now - m_last_sync >= m_policy.sync_interval))
+		{
+			return take_flush(false, p_now);
+		}
+	}
+	else if(m_unsynced && m_policy.sync_interval.count() && p_now - m_last_sync >= m_policy.sync_interval)
+	{
+		m_unsynced = false;
+		m_last_sync = p_now;
+		return action::sync;
+	}
+	return action::none;
+}
+
+flush_control::clock::time_point flush_control::deadline() const
+{
+	clock::time_point res = clock::time_point::max();
+	if(m_unflushed && m_policy.flush_interval.count())
+	{
+		res = m_unflushed_since + m_policy.flush_interval;
+	}
+	if((m_unflushed || m_unsynced) && m_policy.sync_interval.count() && m_last_sync + m_policy.sync_interval < res)
+	{
+		res = m_last_sync + m_policy.sync_interval;
+	}
+	return res;
+}
+
+file_sync::~file_sync()
+{
+	close();
+}
+
+#ifdef _WIN32
+
+bool file_sync::open(std::filesystem::path const& p_fileName)
+{
+	close();
+	HANDLE const handle = CreateFileW(p_fileName.native().c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if(handle == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+	m_handle = handle;
+	return true;
+}
+
+void file_sync::close()
+{
+	if(m_handle)
+	{
+		CloseHandle(m_handle);
+		m_handle = nullptr;
+	}
+}
+
+void file_sync::sync()
+{
+	if(m_handle)
+	{
+		FlushFileBuffers(m_handle);
+	}
+}
+
+#else
+
+bool file_sync::open(std::filesystem::path const& p_fileName)
+{
+	close();
+	m_handle = ::open(p_fileName.c_str(), O_WRONLY | O_CLOEXEC);
+	return m_handle != -1;
+}
+
+void file_sync::close()
+{
+	if(m_handle != -1)
+	{
+		::close(m_handle);
+		m_handle = -1;
+	}
+}
+
+void file_sync::sync()
+{
+	if(m_handle != -1)
+	{
+#ifdef __APPLE__
+		fsync(m_handle);
+#else
+		fdatasync(m_handle);
+#endif
+	}
+}
+
+#endif
+
+} //namespace logger::_p
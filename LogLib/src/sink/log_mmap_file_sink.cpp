@@ -0,0 +1,388 @@
+//======== ======== ======== ======== ======== ======== ======== ========
+///	\file
+///
+///	\copyright
+///		Copyright (c) Tiago Miguel Oliveira Freire
+///
+///		Permission is hereby granted, free of charge, to any person obtaining a copy
+///		of this software and associated documentation files (the "Software"),
+///		to copy, modify, publish, and/or distribute copies of the Software,
+///		and to permit persons to whom the Software is furnished to do so,
+///		subject to the following conditions:
+///
+///		The copyright notice and this permission notice shall be included in all
+///		copies or substantial portions of the Software.
+///		The copyrighted work, or derived works, shall not be used to train
+///		Artificial Intelligence models of any sort; or otherwise be used in a
+///		transformative way that could obfuscate the source of the copyright.
+///
+///		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+///		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+///		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+///		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+///		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+///		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+///		SOFTWARE.
+//======== ======== ======== ======== ======== ======== ======== ========
+
+
+#include <LogLib/sink/log_mmap_file_sink.hpp>
+
+#include <algorithm>
+#include <array>
+
+#include <LogLib/log_scratch.hpp>
+#include <LogLib/sink/log_file_format.hpp>
+
+#ifdef _WIN32
+#	include <Windows.h>
+#else
+#	include <cerrno>
+#	include <fcntl.h>
+#	include <unistd.h>
+#	include <sys/mman.h>
+#endif
+
+namespace logger
+{
+
+//allocation granularity of MapViewOfFile, also a multiple of the page size
+static constexpr uintptr_t chunk_alignment = 0x10000;
+
+log_mmap_file_sink::log_mmap_file_sink() = default;
+
+log_mmap_file_sink::~log_mmap_file_sink()
+{
+	end();
+}
+
+log_field log_mmap_file_sink::required_fields() const
+{
+	//the message is rendered directly into the mapping
+	return log_field::level | log_field::date | log_field::time | log_field::thread | log_field::line | log_field::column;
+}
+
+void log_mmap_file_sink::output(log_data const& p_logData)
+{
+	if(!m_thread.joinable()) return;
+
+	uintptr_t const fileName_size = _p::file_record_name_size(p_logData);
+	uintptr_t const size = _p::file_record_size(p_logData, fileName_size);
+	uint64_t  const offset = m_offset.fetch_add(size, std::memory_order::relaxed);
+	uint64_t  const index  = offset / m_chunk_size;
+	uintptr_t const pos    = static_cast<uintptr_t>(offset % m_chunk_size);
+
+	if(pos + size <= m_chunk_size)
+	{
+		char8_t* const data = get_chunk(index);
+		if(data)
+		{
+			_p::file_record_write(p_logData, data + pos, fileName_size);
+			commit(index, size);
+		}
+	}
+	else
+	{
+		//crosses into the next chunk
+		log_scratch<char8_t> const buff{size};
+		_p::file_record_write(p_logData, buff.data(), fileName_size);
+		copy(offset, buff.data(), size);
+	}
+}
+
+void log_mmap_file_sink::output_batch(std::span<log_data const> const p_records)
+{
+	if(!m_thread.joinable()) return;
+
+	uintptr_t size = 0;
+	for(log_data const& record: p_records)
+	{
+		size += _p::file_record_size(record, _p::file_record_name_size(record));
+	}
+
+	uint64_t  const offset = m_offset.fetch_add(size, std::memory_order::relaxed);
+	uint64_t  const index  = offset / m_chunk_size;
+	uintptr_t const pos    = static_cast<uintptr_t>(offset % m_chunk_size);
+
+	if(pos + size <= m_chunk_size)
+	{
+		char8_t* const data = get_chunk(index);
+		if(data)
+		{
+			char8_t* pivot = data + pos;
+			for(log_data const& record: p_records)
+			{
+				pivot = _p::file_record_write(record, pivot, _p::file_record_name_size(record));
+			}
+			commit(index, size);
+		}
+	}
+	else
+	{
+		log_scratch<char8_t> const buff{size};
+		char8_t* pivot = buff.data();
+		for(log_data const& record: p_records)
+		{
+			pivot = _p::file_record_write(record, pivot, _p::file_record_name_size(record));
+		}
+		copy(offset, buff.data(), size);
+	}
+}
+
+char8_t* log_mmap_file_sink::get_chunk(uint64_t const p_index)
+{
+	//the first thread to reach a chunk asks for the next one to be mapped
+	uint64_t wanted = m_wanted.load(std::memory_order::relaxed);
+	if(wanted < p_index)
+	{
+		while(wanted < p_index && !m_wanted.compare_exchange_weak(wanted, p_index, std::memory_order::relaxed));
+		m_trap.signal();
+	}
+
+	chunk& target = m_chunks[p_index % chunk_slots];
+	while(target.ready.load(std::memory_order::acquire) != p_index + 1)
+	{
+		//the chunk will never be mapped if the sink is closing
+		if(m_failed.load(std::memory_order::relaxed) || m_quit.load(std::memory_order::relaxed))
+		{
+			return nullptr;
+		}
+		core::yield();
+	}
+	return target.data;
+}
+
+void log_mmap_file_sink::commit(uint64_t const p_index, uintptr_t const p_size)
+{
+	chunk& target = m_chunks[p_index % chunk_slots];
+	if(target.committed.fetch_add(p_size, std::memory_order::acq_rel) + p_size == m_chunk_size)
+	{
+		//the chunk is complete and can be unmapped
+		m_trap.signal();
+	}
+}
+
+void log_mmap_file_sink::copy(uint64_t p_offset, char8_t const* p_data, uintptr_t p_size)
+{
+	while(p_size)
+	{
+		uint64_t  const index = p_offset / m_chunk_size;
+		uintptr_t const pos   = static_cast<uintptr_t>(p_offset % m_chunk_size);
+		uintptr_t const size  = std::min(p_size, m_chunk_size - pos);
+
+		char8_t* const data = get_chunk(index);
+		if(!data)
+		{
+			return;
+		}
+		memcpy(data + pos, p_data, size);
+		commit(index, size);
+
+		p_offset += size;
+		p_data   += size;
+		p_size   -= size;
+	}
+}
+
+void log_mmap_file_sink::run(void*)
+{
+	while(true)
+	{
+		m_trap.reset();
+
+		for(chunk& target: m_chunks)
+		{
+			if(target.ready.load(std::memory_order::relaxed) && target.committed.load(std::memory_order::acquire) == m_chunk_size)
+			{
+				unmap_chunk(target);
+			}
+		}
+
+		//keeps one chunk mapped ahead of the logging threads
+		uint64_t const ahead = m_wanted.load(std::memory_order::relaxed) + 1;
+		while(m_next_chunk <= ahead && !m_failed.load(std::memory_order::relaxed))
+		{
+			chunk& target = m_chunks[m_next_chunk % chunk_slots];
+			if(target.ready.load(std::memory_order::relaxed))
+			{
+				//slot still in use by an incomplete chunk
+				break;
+			}
+			if(!map_chunk(m_next_chunk, target))
+			{
+				m_failed.store(true, std::memory_order::relaxed);
+				break;
+			}
+			++m_next_chunk;
+		}
+
+		if(m_quit.load(std::memory_order::acquire))
+		{
+			return;
+		}
+		m_trap.wait();
+	}
+}
+
+#ifdef _WIN32
+
+bool log_mmap_file_sink::map_chunk(uint64_t const p_index, chunk& p_chunk)
+{
+	uint64_t const offset = p_index * m_chunk_size;
+	uint64_t const end = offset + m_chunk_size;
+
+	//the mapping grows the file to its size
+	HANDLE const mapping = CreateFileMappingW(m_file, nullptr, PAGE_READWRITE, static_cast<DWORD>(end >> 32), static_cast<DWORD>(end), nullptr);
+	if(!mapping)
+	{
+		return false;
+	}
+	void* const view = MapViewOfFile(mapping, FILE_MAP_WRITE, static_cast<DWORD>(offset >> 32), static_cast<DWORD>(offset), m_chunk_size);
+	CloseHandle(mapping);
+	if(!view)
+	{
+		return false;
+	}
+
+	p_chunk.data = static_cast<char8_t*>(view);
+	p_chunk.committed.store(0, std::memory_order::relaxed);
+	p_chunk.ready.store(p_index + 1, std::memory_order::release);
+	return true;
+}
+
+void log_mmap_file_sink::unmap_chunk(chunk& p_chunk)
+{
+	UnmapViewOfFile(p_chunk.data);
+	p_chunk.data = nullptr;
+	p_chunk.committed.store(0, std::memory_order::relaxed);
+	p_chunk.ready.store(0, std::memory_order::release);
+}
+
+#else
+
+bool log_mmap_file_sink::map_chunk(uint64_t const p_index, chunk& p_chunk)
+{
+	off_t const offset = static_cast<off_t>(p_index * m_chunk_size);
+
+	//reserves the blocks ahead of time, so that page faults on the mapping do not have to allocate them
+#ifdef __linux__
+	if(fallocate(m_file, 0, offset, static_cast<off_t>(m_chunk_size)) != 0)
+	{
+		if(errno != EOPNOTSUPP && errno != ENOSYS)
+		{
+			return false;
+		}
+		if(ftruncate(m_file, offset + static_cast<off_t>(m_chunk_size)) != 0)
+		{
+			return false;
+		}
+	}
+#else
+	if(ftruncate(m_file, offset + static_cast<off_t>(m_chunk_size)) != 0)
+	{
+		return false;
+	}
+#endif
+
+	void* const view = mmap(nullptr, m_chunk_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_file, offset);
+	if(view == MAP_FAILED)
+	{
+		return false;
+	}
+
+	p_chunk.data = static_cast<char8_t*>(view);
+	p_chunk.committed.store(0, std::memory_order::relaxed);
+	p_chunk.ready.store(p_index + 1, std::memory_order::release);
+	return true;
+}
+
+void log_mmap_file_sink::unmap_chunk(chunk& p_chunk)
+{
+	munmap(p_chunk.data, m_chunk_size);
+	p_chunk.data = nullptr;
+	p_chunk.committed.store(0, std::memory_order::relaxed);
+	p_chunk.ready.store(0, std::memory_order::release);
+}
+
+#endif
+
+bool log_mmap_file_sink::init(std::filesystem::path const& p_fileName, uintptr_t const p_chunk_size)
+{
+	end();
+
+#ifdef _WIN32
+	HANDLE const file = CreateFileW(p_fileName.native().c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if(file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+#else
+	int const file = ::open(p_fileName.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if(file == -1)
+	{
+		return false;
+	}
+#endif
+
+	m_file = file;
+	m_chunk_size = (std::max<uintptr_t>(p_chunk_size, 1) + chunk_alignment - 1) & ~(chunk_alignment - 1);
+	m_offset.store(0, std::memory_order::relaxed);
+	m_wanted.store(0, std::memory_order::relaxed);
+	m_failed.store(false, std::memory_order::relaxed);
+	m_quit.store(false, std::memory_order::relaxed);
+	m_next_chunk = 0;
+	m_trap.reset();
+
+	if(m_thread.create(this, &log_mmap_file_sink::run, nullptr) != core::thread::Error::None)
+	{
+		end();
+		return false;
+	}
+
+	constexpr std::array UTF8_BOM = {char8_t{0xEF}, char8_t{0xBB}, char8_t{0xBF}};
+	copy(m_offset.fetch_add(UTF8_BOM.size(), std::memory_order::relaxed), UTF8_BOM.data(), UTF8_BOM.size());
+	return true;
+}
+
+void log_mmap_file_sink::end()
+{
+	if(m_thread.joinable())
+	{
+		m_quit.store(true, std::memory_order::release);
+		m_trap.signal();
+		m_thread.join();
+	}
+
+	for(chunk& target: m_chunks)
+	{
+		if(target.ready.load(std::memory_order::relaxed))
+		{
+			unmap_chunk(target);
+		}
+	}
+
+	//records that could not be mapped were dropped
+	uint64_t const size = std::min<uint64_t>(m_offset.load(std::memory_order::relaxed), m_next_chunk * m_chunk_size);
+
+#ifdef _WIN32
+	if(m_file)
+	{
+		FILE_END_OF_FILE_INFO info;
+		info.EndOfFile.QuadPart = static_cast<LONGLONG>(size);
+		SetFileInformationByHandle(m_file, FileEndOfFileInfo, &info, sizeof(info));
+		CloseHandle(m_file);
+		m_file = nullptr;
+	}
+#else
+	if(m_file != -1)
+	{
+		[[maybe_unused]] int const res = ftruncate(m_file, static_cast<off_t>(size));
+		::close(m_file);
+		m_file = -1;
+	}
+#endif
+	m_offset.store(0, std::memory_order::relaxed);
+	m_next_chunk = 0;
+}
+
+} //namespace simLog
@@ -0,0 +1,408 @@
+//======== ======== ======== ======== ======== ======== ======== ========
+///	\file
+///
+///	\copyright
+///		Copyright (c) Tiago Miguel Oliveira Freire
+///
+///		Permission is hereby granted, free of charge, to any person obtaining a copy
+///		of this software and associated documentation files (the "Software"),
+///		to copy, modify, publish, and/or distribute copies of the Software,
+///		and to permit persons to whom the Software is furnished to do so,
+///		subject to the following conditions:
+///
+///		The copyright notice and this permission notice shall be included in all
+///		copies or substantial portions of the Software.
+///		The copyrighted work, or derived works, shall not be used to train
+///		Artificial Intelligence models of any sort; or otherwise be used in a
+///		transformative way that could obfuscate the source of the copyright.
+///
+///		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+///		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+///		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+///		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+///		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+///		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+///		SOFTWARE.
+//======== ======== ======== ======== ======== ======== ======== ========
+
+
+#include <LogLib/sink/log_rotating_file_sink.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <CoreLib/core_alloca.hpp>
+
+#include <LogLib/log_scratch.hpp>
+#include <LogLib/sink/log_file_format.hpp>
+
+namespace logger
+{
+
+static constexpr std::array UTF8_BOM = {char8_t{0xEF}, char8_t{0xBB}, char8_t{0xBF}};
+
+//retries to open the next file after a failure
+static constexpr std::chrono::milliseconds retry_interval{1000};
+
+///	\brief Parses the number of a file named <stem>.<number><extension>, followed by anything (ex. a compression extension)
+static bool segment_number(std::filesystem::path::string_type const& p_name, std::filesystem::path::string_type const& p_prefix, std::filesystem::path::string_type const& p_extension, uint64_t& p_number)
+{
+	if(p_name.size() <= p_prefix.size() || p_name.compare(0, p_prefix.size(), p_prefix) != 0)
+	{
+		return false;
+	}
+
+	uintptr_t pos = p_prefix.size();
+	uint64_t number = 0;
+	for(; pos < p_name.size() && p_name[pos] >= '0' && p_name[pos] <= '9'; ++pos)
+	{
+		number = number * 10 + static_cast<uint64_t>(p_name[pos] - '0');
+	}
+	if(pos == p_prefix.size() || p_name.compare(pos, p_extension.size(), p_extension) != 0)
+	{
+		return false;
+	}
+	p_number = number;
+	return true;
+}
+
+static std::chrono::system_clock::time_point next_boundary(std::chrono::system_clock::time_point const p_now, std::chrono::seconds const p_interval)
+{
+	std::chrono::seconds const since_epoch = std::chrono::duration_cast<std::chrono::seconds>(p_now.time_since_epoch());
+	return std::chrono::system_clock::time_point{(since_epoch / p_interval + 1) * p_interval};
+}
+
+log_rotating_file_sink::log_rotating_file_sink() = default;
+
+log_rotating_file_sink::~log_rotating_file_sink()
+{
+	end();
+}
+
+log_field log_rotating_file_sink::required_fields() const
+{
+	//the message is rendered directly into the write buffer
+	return log_field::level | log_field::date | log_field::time | log_field::thread | log_field::line | log_field::column;
+}
+
+void log_rotating_file_sink::output(log_data const& p_logData)
+{
+	if(!m_thread.joinable()) return;
+
+	uintptr_t const fileSize_estimate = _p::file_record_name_size(p_logData);
+	uintptr_t const count = _p::file_record_size(p_logData, fileSize_estimate);
+
+	constexpr uintptr_t alloca_treshold = 0x10000;
+
+	if(count > alloca_treshold)
+	{
+		log_scratch<char8_t> const buff{count};
+		_p::file_record_write(p_logData, buff.data(), fileSize_estimate);
+		write(buff.data(), count);
+	}
+	else
+	{
+		char8_t* buff = reinterpret_cast<char8_t*>(core_alloca(count));
+		_p::file_record_write(p_logData, buff, fileSize_estimate);
+		write(buff, count);
+	}
+}
+
+void log_rotating_file_sink::output_batch(std::span<log_data const> const p_records)
+{
+	if(!m_thread.joinable()) return;
+
+	uintptr_t count = 0;
+	for(log_data const& record: p_records)
+	{
+		count += _p::file_record_size(record, _p::file_record_name_size(record));
+	}
+
+	log_scratch<char8_t> const buff{count};
+	char8_t* pivot = buff.data();
+	for(log_data const& record: p_records)
+	{
+		pivot = _p::file_record_write(record, pivot, _p::file_record_name_size(record));
+	}
+	write(buff.data(), count);
+}
+
+void log_rotating_file_sink::write(void const* const p_data, uintptr_t const p_size)
+{
+	//registers as a user of the active segment, then checks that it was not replaced in the mean time,
+	//the background thread only closes a replaced segment once it has no users
+	uint64_t generation;
+	segment* target;
+	while(true)
+	{
+		generation = m_generation.load(std::memory_order::seq_cst);
+		target = &m_segments[generation & 1];
+		target->users.fetch_add(1, std::memory_order::seq_cst);
+		if(m_generation.load(std::memory_order::seq_cst) == generation)
+		{
+			break;
+		}
+		target->users.fetch_sub(1, std::memory_order::release);
+	}
+
+	target->file.write(p_data, p_size);
+	uint64_t const size = target->size.fetch_add(p_size, std::memory_order::relaxed) + p_size;
+	target->users.fetch_sub(1, std::memory_order::release);
+
+	if(m_policy.max_size && size >= m_policy.max_size)
+	{
+		try_rotate(generation);
+	}
+}
+
+void log_rotating_file_sink::try_rotate(uint64_t const p_generation)
+{
+	//only one thread can claim the next segment, if it is not ready the current one is kept
+	bool ready = true;
+	if(!m_ready.compare_exchange_strong(ready, false, std::memory_order::acq_rel))
+	{
+		return;
+	}
+
+	//the generation and not the index is compared, a thread holding on to a full segment
+	//must not rotate again after the segment was replaced, and then reused for the next file
+	uint64_t generation = p_generation;
+	if(!m_generation.compare_exchange_strong(generation, p_generation + 1, std::memory_order::seq_cst))
+	{
+		//already rotated
+		m_ready.store(true, std::memory_order::release);
+		return;
+	}
+
+	m_retiring.store(true, std::memory_order::release);
+	m_trap.signal();
+}
+
+bool log_rotating_file_sink::open_segment(segment& p_segment)
+{
+	std::array<char, 24> number;
+	snprintf(number.data(), number.size(), ".%06llu", static_cast<unsigned long long>(m_sequence));
+
+	std::filesystem::path name = m_stem;
+	name += number.data();
+	name += m_extension;
+	std::filesystem::path const path = m_directory / name;
+
+	if(p_segment.file.open(path, core::file_write::open_mode::create, true) != std::errc{})
+	{
+		return false;
+	}
+	++m_sequence;
+
+	p_segment.file.write(UTF8_BOM.data(), UTF8_BOM.size());
+	p_segment.path = path;
+	p_segment.size.store(UTF8_BOM.size(), std::memory_order::relaxed);
+	return true;
+}
+
+void log_rotating_file_sink::close_segment(std::filesystem::path const& p_path)
+{
+	std::filesystem::path result = p_path;
+	if(m_compressor)
+	{
+		std::filesystem::path const compressed = m_compressor->compress(p_path);
+		if(!compressed.empty() && compressed != p_path)
+		{
+			std::error_code ec;
+			std::filesystem::remove(p_path, ec);
+			result = compressed;
+		}
+	}
+	m_closed.push_back(std::move(result));
+
+	while(m_policy.retention && m_closed.size() > m_policy.retention)
+	{
+		std::error_code ec;
+		std::filesystem::remove(m_closed.front(), ec);
+		m_closed.pop_front();
+	}
+}
+
+void log_rotating_file_sink::run(void*)
+{
+	bool const timed = m_policy.interval.count() > 0;
+	std::chrono::system_clock::time_point boundary = timed ? next_boundary(std::chrono::system_clock::now(), m_policy.interval) : std::chrono::system_clock::time_point::max();
+
+	while(true)
+	{
+		m_trap.reset();
+
+		if(m_retiring.load(std::memory_order::acquire))
+		{
+			segment& old = m_segments[(m_generation.load(std::memory_order::seq_cst) & 1) ^ 1];
+			while(old.users.load(std::memory_order::seq_cst))
+			{
+				core::yield();
+			}
+			old.file.close();
+			std::filesystem::path const closed = std::move(old.path);
+			old.path.clear();
+			m_retiring.store(false, std::memory_order::relaxed);
+
+			//the next segment is prepared before the slow work
+			if(open_segment(old))
+			{
+				m_ready.store(true, std::memory_order::release);
+			}
+			close_segment(closed);
+		}
+		else if(!m_ready.load(std::memory_order::acquire))
+		{
+			segment& next = m_segments[(m_generation.load(std::memory_order::seq_cst) & 1) ^ 1];
+			if(open_segment(next))
+			{
+				m_ready.store(true, std::memory_order::release);
+			}
+		}
+
+		if(timed && std::chrono::system_clock::now() >= boundary)
+		{
+			boundary = next_boundary(std::chrono::system_clock::now(), m_policy.interval);
+			uint64_t const generation = m_generation.load(std::memory_order::seq_cst);
+			//an empty file is not worth rotating
+			if(m_segments[generation & 1].size.load(std::memory_order::relaxed) > UTF8_BOM.size())
+			{
+				try_rotate(generation);
+			}
+		}
+
+		if(m_retiring.load(std::memory_order::acquire))
+		{
+			continue;
+		}
+
+		if(m_quit.load(std::memory_order::acquire))
+		{
+			return;
+		}
+
+		if(!m_ready.load(std::memory_order::acquire))
+		{
+			m_trap.wait_for(retry_interval);
+		}
+		else if(timed)
+		{
+			std::chrono::system_clock::time_point const now = std::chrono::system_clock::now();
+			if(boundary > now)
+			{
+				m_trap.wait_for(std::chrono::ceil<std::chrono::milliseconds>(boundary - now));
+			}
+		}
+		else
+		{
+			m_trap.wait();
+		}
+	}
+}
+
+void log_rotating_file_sink::set_rotation_policy(log_rotation_policy const& p_policy)
+{
+	m_policy = p_policy;
+}
+
+void log_rotating_file_sink::set_compressor(log_segment_compressor* const p_compressor)
+{
+	m_compressor = p_compressor;
+}
+
+bool log_rotating_file_sink::init(std::filesystem::path const& p_fileName)
+{
+	end();
+	bool const input_absolute = p_fileName.is_absolute();
+	std::error_code ec;
+	std::filesystem::path const& fileName =
+		input_absolute ?
+		p_fileName :
+		std::filesystem::absolute(p_fileName, ec);
+
+	if(!input_absolute && ec != std::error_code{})
+	{
+		return false;
+	}
+
+	m_directory = fileName.parent_path();
+	m_stem      = fileName.stem();
+	m_extension = fileName.extension();
+
+	//continues after the files of previous runs
+	std::filesystem::path prefix = m_stem;
+	prefix += ".";
+	std::vector<std::pair<uint64_t, std::filesystem::path>> existing;
+	for(std::filesystem::directory_entry const& entry: std::filesystem::directory_iterator{m_directory, ec})
+	{
+		uint64_t number;
+		if(entry.is_regular_file(ec) && segment_number(entry.path().filename().native(), prefix.native(), m_extension.native(), number))
+		{
+			existing.emplace_back(number, entry.path());
+		}
+	}
+	std::sort(existing.begin(), existing.end());
+
+	m_closed.clear();
+	for(std::pair<uint64_t, std::filesystem::path>& file: existing)
+	{
+		m_closed.push_back(std::move(file.second));
+	}
+	m_sequence = existing.empty() ? 1 : existing.back().first + 1;
+
+	m_generation.store(0, std::memory_order::relaxed);
+	m_ready.store(false, std::memory_order::relaxed);
+	m_retiring.store(false, std::memory_order::relaxed);
+	m_quit.store(false, std::memory_order::relaxed);
+	m_trap.reset();
+
+	if(!open_segment(m_segments[0]))
+	{
+		return false;
+	}
+
+	//applies the retention to the files of previous runs
+	while(m_policy.retention && m_closed.size() > m_policy.retention)
+	{
+		std::filesystem::remove(m_closed.front(), ec);
+		m_closed.pop_front();
+	}
+
+	if(m_thread.create(this, &log_rotating_file_sink::run, nullptr) != core::thread::Error::None)
+	{
+		m_segments[0].file.close();
+		return false;
+	}
+	return true;
+}
+
+void log_rotating_file_sink::end()
+{
+	if(m_thread.joinable())
+	{
+		m_quit.store(true, std::memory_order::release);
+		m_trap.signal();
+		m_thread.join();
+	}
+
+	uint64_t const generation = m_generation.load(std::memory_order::relaxed);
+	segment& current = m_segments[generation & 1];
+	current.file.close();
+	current.path.clear();
+
+	//the next file was never written
+	segment& next = m_segments[(generation & 1) ^ 1];
+	if(m_ready.exchange(false, std::memory_order::relaxed))
+	{
+		next.file.close();
+		std::error_code ec;
+		std::filesystem::remove(next.path, ec);
+	}
+	next.path.clear();
+}
+
+} //namespace simLog
@@ -0,0 +1,529 @@
+//======== ======== ======== ======== ======== ======== ======== ========
+///	\file
+///
+///	\copyright
+///		Copyright (c) Tiago Miguel Oliveira Freire
+///
+///		Permission is hereby granted, free of charge, to any person obtaining a copy
+///		of this software and associated documentation files (the "Software"),
+///		to copy, modify, publish, and/or distribute copies of the Software,
+///		and to permit persons to whom the Software is furnished to do so,
+///		subject to the following conditions:
+///
+///		The copyright notice and this permission notice shall be included in all
+///		copies or substantial portions of the Software.
+///		The copyrighted work, or derived works, shall not be used to train
+///		Artificial Intelligence models of any sort; or otherwise be used in a
+///		transformative way that could obfuscate the source of the copyright.
+///
+///		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+///		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+///		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+///		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+///		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+///		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+///		SOFTWARE.
+//======== ======== ======== ======== ======== ======== ======== ========
+
+
+#include <LogLib/sink/log_uring_writer.hpp>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#	define _P_LOG_HAS_URING
+#endif
+
+#ifdef _P_LOG_HAS_URING
+#	include <algorithm>
+#	include <atomic>
+#	include <cerrno>
+#	include <cstring>
+#	include <vector>
+
+#	include <fcntl.h>
+#	include <unistd.h>
+#	include <sys/mman.h>
+#	include <sys/syscall.h>
+#	include <sys/uio.h>
+#	include <linux/io_uring.h>
+#endif
+
+namespace logger::_p
+{
+
+#ifdef _P_LOG_HAS_URING
+
+//the system calls are used directly to avoid depending on liburing
+static inline int uring_setup(uint32_t const p_entries, io_uring_params& p_params)
+{
+	return static_cast<int>(syscall(__NR_io_uring_setup, p_entries, &p_params));
+}
+
+static inline int uring_enter(int const p_ring, uint32_t const p_submit, uint32_t const p_wait)
+{
+	return static_cast<int>(syscall(__NR_io_uring_enter, p_ring, p_submit, p_wait, p_wait ? IORING_ENTER_GETEVENTS : 0u, nullptr, 0));
+}
+
+static inline int uring_register(int const p_ring, uint32_t const p_opcode, void const* const p_arg, uint32_t const p_count)
+{
+	return static_cast<int>(syscall(__NR_io_uring_register, p_ring, p_opcode, p_arg, p_count));
+}
+
+static inline void* map_ring(int const p_ring, uintptr_t const p_size, uint64_t const p_offset)
+{
+	return mmap(nullptr, p_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, p_ring, static_cast<off_t>(p_offset));
+}
+
+struct uring_writer::ring
+{
+	struct slot
+	{
+		uint64_t  offset; //!< Position in the file
+		uintptr_t done;   //!< Bytes already written
+		uintptr_t size;
+	};
+
+	~ring()
+	{
+		if(buffers != MAP_FAILED) munmap(buffers, buffer_size * buffer_count);
+		if(sqes     != MAP_FAILED) munmap(sqes, sqes_size);
+		if(cq_map   != MAP_FAILED && cq_map != sq_map) munmap(cq_map, cq_map_size);
+		if(sq_map   != MAP_FAILED) munmap(sq_map, sq_map_size);
+		if(ring_fd != -1) ::close(ring_fd);
+		if(file_fd != -1) ::close(file_fd);
+	}
+
+	bool init(std::filesystem::path const& p_fileName, log_uring_config const& p_config)
+	{
+		buffer_count = std::min<uint32_t>(p_config.buffer_count, 1024);
+		buffer_size  = std::min<uintptr_t>(p_config.buffer_size, 0x40000000);
+		if(buffer_count == 0 || buffer_size == 0)
+		{
+			return false;
+		}
+
+		file_fd = ::open(p_fileName.c_str(), O_WRONLY | O_CLOEXEC);
+		if(file_fd == -1)
+		{
+			return false;
+		}
+		off_t const end = lseek(file_fd, 0, SEEK_END);
+		if(end < 0)
+		{
+			return false;
+		}
+		offset = static_cast<uint64_t>(end);
+
+		io_uring_params params{};
+		ring_fd = uring_setup(buffer_count, params);
+		if(ring_fd < 0)
+		{
+			ring_fd = -1;
+			return false;
+		}
+
+		sq_map_size = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+		cq_map_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+		bool const single_map = params.features & IORING_FEAT_SINGLE_MMAP;
+		if(single_map)
+		{
+			sq_map_size = cq_map_size = std::max(sq_map_size, cq_map_size);
+		}
+
+		sq_map = map_ring(ring_fd, sq_map_size, IORING_OFF_SQ_RING);
+		if(sq_map == MAP_FAILED)
+		{
+			return false;
+		}
+		cq_map = single_map ? sq_map : map_ring(ring_fd, cq_map_size, IORING_OFF_CQ_RING);
+		if(cq_map == MAP_FAILED)
+		{
+			return false;
+		}
+		sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+		sqes = map_ring(ring_fd, sqes_size, IORING_OFF_SQES);
+		if(sqes == MAP_FAILED)
+		{
+			return false;
+		}
+
+		char* const sq = static_cast<char*>(sq_map);
+		char* const cq = static_cast<char*>(cq_map);
+		sq_tail  = reinterpret_cast<uint32_t*>(sq + params.sq_off.tail);
+		sq_mask  = *reinterpret_cast<uint32_t const*>(sq + params.sq_off.ring_mask);
+		sq_array = reinterpret_cast<uint32_t*>(sq + params.sq_off.array);
+		cq_head  = reinterpret_cast<uint32_t*>(cq + params.cq_off.head);
+		cq_tail  = reinterpret_cast<uint32_t*>(cq + params.cq_off.tail);
+		cq_mask  = *reinterpret_cast<uint32_t const*>(cq + params.cq_off.ring_mask);
+		cqes     = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+		buffers = mmap(nullptr, buffer_size * buffer_count, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if(buffers == MAP_FAILED)
+		{
+			return false;
+		}
+
+		//registered buffers spare the kernel from mapping the pages on every write,
+		//registration may fail if the buffers exceed RLIMIT_MEMLOCK, in which case plain writes are used
+		{
+			std::vector<iovec> iov(buffer_count);
+			for(uint32_t i = 0; i < buffer_count; ++i)
+			{
+				iov[i].iov_base = buffer(i);
+				iov[i].iov_len  = buffer_size;
+			}
+			fixed = uring_register(ring_fd, IORING_REGISTER_BUFFERS, iov.data(), buffer_count) == 0;
+		}
+		if(!fixed && !(params.features & IORING_FEAT_RW_CUR_POS))
+		{
+			//IORING_OP_WRITE is not available before the same kernel version (5.6)
+			return false;
+		}
+
+		slots.resize(buffer_count);
+		free.reserve(buffer_count);
+		for(uint32_t i = buffer_count; i--;)
+		{
+			free.push_back(i);
+		}
+		return true;
+	}
+
+	inline bool has_failed() const
+	{
+		return failed.load(std::memory_order::relaxed);
+	}
+
+	inline char8_t* buffer(uint32_t const p_index) const
+	{
+		return static_cast<char8_t*>(buffers) + p_index * buffer_size;
+	}
+
+	void queue(uint32_t const p_index)
+	{
+		slot const& target = slots[p_index];
+
+		//this is the only producer, the tail can be read relaxed
+		uint32_t const tail = std::atomic_ref<uint32_t>{*sq_tail}.load(std::memory_order::relaxed);
+		uint32_t const pos  = tail & sq_mask;
+
+		io_uring_sqe& sqe = static_cast<io_uring_sqe*>(sqes)[pos];
+		memset(&sqe, 0, sizeof(sqe));
+		sqe.opcode    = fixed ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+		sqe.fd        = file_fd;
+		sqe.off       = target.offset + target.done;
+		sqe.addr      = reinterpret_cast<uint64_t>(buffer(p_index) + target.done);
+		sqe.len       = static_cast<uint32_t>(target.size - target.done);
+		sqe.buf_index = fixed ? static_cast<uint16_t>(p_index) : 0;
+		sqe.user_data = p_index;
+		sq_array[pos] = pos;
+
+		std::atomic_ref<uint32_t>{*sq_tail}.store(tail + 1, std::memory_order::release);
+		++unsubmitted;
+	}
+
+	///	\brief Submits the queued writes, and waits for at least p_wait completions
+	///	\return 0 on success, otherwise the error of io_uring_enter, in which case no completion is to be expected
+	int enter(uint32_t const p_wait)
+	{
+		while(true)
+		{
+			int const res = uring_enter(ring_fd, unsubmitted, p_wait);
+			if(res >= 0)
+			{
+				unsubmitted -= static_cast<uint32_t>(res);
+				if(unsubmitted == 0 || p_wait)
+				{
+					return 0;
+				}
+			}
+			else if(errno != EINTR && errno != EAGAIN && errno != EBUSY)
+			{
+				return errno;
+			}
+		}
+	}
+
+	///	\brief Gives up on the ring, the buffers not yet written are written synchronously, and so is any further data
+	void fail()
+	{
+		failed.store(true, std::memory_order::relaxed);
+
+		std::vector<bool> idle(buffer_count, false);
+		for(uint32_t const index: free)
+		{
+			idle[index] = true;
+		}
+		if(current != no_buffer)
+		{
+			slots[current] = slot{.offset = offset, .done = 0, .size = used};
+			offset += used;
+			idle[current] = false;
+		}
+
+		//a write still in flight may land as well, with the same data at the same position
+		free.clear();
+		for(uint32_t i = buffer_count; i--;)
+		{
+			if(!idle[i])
+			{
+				write_sync(i);
+			}
+			free.push_back(i);
+		}
+		current = no_buffer;
+		used = 0;
+		unsubmitted = 0;
+	}
+
+	///	\brief Writes the rest of a buffer with pwrite
+	void write_sync(uint32_t const p_index)
+	{
+		slot& target = slots[p_index];
+		while(target.done < target.size)
+		{
+			ssize_t const res = pwrite(file_fd, buffer(p_index) + target.done, target.size - target.done, static_cast<off_t>(target.offset + target.done));
+			if(res <= 0)
+			{
+				break;
+			}
+			target.done += static_cast<uintptr_t>(res);
+		}
+	}
+
+	///	\brief Writes data with pwrite, once the ring has failed
+	void write_direct(char8_t const* p_data, uintptr_t const p_size)
+	{
+		for(uintptr_t done = 0; done < p_size;)
+		{
+			ssize_t const res = pwrite(file_fd, p_data + done, p_size - done, static_cast<off_t>(offset + done));
+			if(res <= 0)
+			{
+				break;
+			}
+			done += static_cast<uintptr_t>(res);
+		}
+		offset += p_size;
+	}
+
+	void reap()
+	{
+		uint32_t head = std::atomic_ref<uint32_t>{*cq_head}.load(std::memory_order::relaxed);
+		uint32_t const tail = std::atomic_ref<uint32_t>{*cq_tail}.load(std::memory_order::acquire);
+
+		for(; head != tail; ++head)
+		{
+			io_uring_cqe const& cqe = cqes[head & cq_mask];
+			complete(static_cast<uint32_t>(cqe.user_data), cqe.res);
+		}
+		std::atomic_ref<uint32_t>{*cq_head}.store(head, std::memory_order::release);
+	}
+
+	void complete(uint32_t const p_index, int32_t const p_res)
+	{
+		slot& target = slots[p_index];
+		if(p_res > 0)
+		{
+			target.done += static_cast<uintptr_t>(p_res);
+			if(target.done < target.size)
+			{
+				//short write
+				queue(p_index);
+				return;
+			}
+		}
+		else if(p_res == -EINTR || p_res == -EAGAIN)
+		{
+			queue(p_index);
+			return;
+		}
+		else
+		{
+			//the ring could not write the data, try once more without it
+			write_sync(p_index);
+		}
+		free.push_back(p_index);
+	}
+
+	///	\return no_buffer if the ring failed
+	uint32_t acquire()
+	{
+		reap();
+		while(free.empty())
+		{
+			if(enter(1) != 0)
+			{
+				fail();
+				return no_buffer;
+			}
+			reap();
+		}
+		uint32_t const index = free.back();
+		free.pop_back();
+		return index;
+	}
+
+	///	\brief Queues the buffer being filled
+	void submit_current()
+	{
+		slots[current] = slot{.offset = offset, .done = 0, .size = used};
+		offset += used;
+		queue(current);
+		current = no_buffer;
+		used = 0;
+	}
+
+	void write(char8_t const* p_data, uintptr_t p_size)
+	{
+		if(failed.load(std::memory_order::relaxed))
+		{
+			write_direct(p_data, p_size);
+			return;
+		}
+
+		//data is gathered in the current buffer, which is only submitted once full
+		bool submitted = false;
+		while(p_size)
+		{
+			if(current == no_buffer)
+			{
+				current = acquire();
+				if(current == no_buffer)
+				{
+					write_direct(p_data, p_size);
+					return;
+				}
+			}
+			uintptr_t const size = std::min(p_size, buffer_size - used);
+			memcpy(buffer(current) + used, p_data, size);
+			used += size;
+			p_data += size;
+			p_size -= size;
+
+			if(used == buffer_size)
+			{
+				submit_current();
+				submitted = true;
+			}
+		}
+		if(submitted && enter(0) != 0)
+		{
+			fail();
+		}
+	}
+
+	void wait_all()
+	{
+		if(failed.load(std::memory_order::relaxed))
+		{
+			return;
+		}
+
+		if(current != no_buffer)
+		{
+			submit_current();
+		}
+		reap();
+		while(free.size() < buffer_count)
+		{
+			if(enter(1) != 0)
+			{
+				fail();
+				return;
+			}
+			reap();
+		}
+	}
+
+	int file_fd = -1;
+	int ring_fd = -1;
+
+	void* sq_map = MAP_FAILED;
+	void* cq_map = MAP_FAILED;
+	void* sqes   = MAP_FAILED;
+	void* buffers = MAP_FAILED;
+	uintptr_t sq_map_size = 0;
+	uintptr_t cq_map_size = 0;
+	uintptr_t sqes_size   = 0;
+
+	uint32_t* sq_tail  = nullptr;
+	uint32_t* sq_array = nullptr;
+	uint32_t  sq_mask  = 0;
+	uint32_t* cq_head  = nullptr;
+	uint32_t* cq_tail  = nullptr;
+	uint32_t  cq_mask  = 0;
+	io_uring_cqe* cqes = nullptr;
+
+	uint32_t  buffer_count = 0;
+	uintptr_t buffer_size  = 0;
+	bool fixed = false;
+	std::atomic<bool> failed = false; //!< io_uring_enter failed, the data is written synchronously
+
+	static constexpr uint32_t no_buffer = ~uint32_t{0};
+
+	std::vector<slot> slots;
+	std::vector<uint32_t> free;     //!< Buffers not in flight
+	uint32_t current = no_buffer;   //!< Buffer being filled, not in flight nor free
+	uintptr_t used = 0;             //!< Bytes in the current buffer
+	uint32_t unsubmitted = 0;       //!< Entries queued but not yet submitted
+	uint64_t offset = 0;            //!< Position of the next write
+};
+
+#else
+
+struct uring_writer::ring
+{
+	bool init(std::filesystem::path const&, log_uring_config const&) { return false; }
+	bool has_failed() const { return false; }
+	void write(char8_t const*, uintptr_t) {}
+	void wait_all() {}
+};
+
+#endif
+
+uring_writer::uring_writer() = default;
+
+uring_writer::~uring_writer()
+{
+	close();
+}
+
+bool uring_writer::open(std::filesystem::path const& p_fileName, log_uring_config const& p_config)
+{
+	close();
+	std::unique_ptr<ring> temp = std::make_unique<ring>();
+	if(!temp->init(p_fileName, p_config))
+	{
+		return false;
+	}
+	m_ring = std::move(temp);
+	return true;
+}
+
+void uring_writer::close()
+{
+	if(m_ring)
+	{
+		m_ring->wait_all();
+		m_ring.reset();
+	}
+}
+
+void uring_writer::write(void const* const p_data, uintptr_t const p_size)
+{
+	m_ring->write(static_cast<char8_t const*>(p_data), p_size);
+}
+
+bool uring_writer::failed() const
+{
+	return m_ring && m_ring->has_failed();
+}
+
+void uring_writer::wait_all()
+{
+	if(m_ring)
+	{
+		m_ring->wait_all();
+	}
+}
+
+} //namespace logger::_p
@@ -0,0 +1,75 @@
+//======== ======== ======== ======== ======== ======== ======== ========
+///	\file
+///
+///	\copyright
+///		Copyright (c) Tiago Miguel Oliveira Freire
+///
+///		Permission is hereby granted, free of charge, to any person obtaining a copy
+///		of this software and associated documentation files (the "Software"),
+///		to copy, modify, publish, and/or distribute copies of the Software,
+///		and to permit persons to whom the Software is furnished to do so,
+///		subject to the following conditions:
+///
+///		The copyright notice and this permission notice shall be included in all
+///		copies or substantial portions of the Software.
+///		The copyrighted work, or derived works, shall not be used to train
+///		Artificial Intelligence models of any sort; or otherwise be used in a
+///		transformative way that could obfuscate the source of the copyright.
+///
+///		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+///		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+///		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+///		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+///		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+///		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+///		SOFTWARE.
+//======== ======== ======== ======== ======== ======== ======== ========
+
+
+///	\brief Prints the records left in a flight recorder file (see log_flight_recorder_sink.hpp),
+///		usage: LogRecover <file> [number of records, 0 for all]
+
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <LogLib/log_flight_recorder.hpp>
+
+static constexpr uintptr_t default_record_count = 100;
+
+int main(int const argc, char const* const argv[])
+{
+	if(argc < 2 || argc > 3)
+	{
+		fprintf(stderr, "Usage: LogRecover <file> [number of records, default %zu, 0 for all]\n", static_cast<size_t>(default_record_count));
+		return 2;
+	}
+
+	uintptr_t count = default_record_count;
+	if(argc == 3)
+	{
+		char const* const last = argv[2] + strlen(argv[2]);
+		std::from_chars_result const res = std::from_chars(argv[2], last, count);
+		if(res.ec != std::errc{} || res.ptr != last)
+		{
+			fprintf(stderr, "Invalid number of records: %s\n", argv[2]);
+			return 2;
+		}
+	}
+
+	std::vector<std::u8string> records;
+	if(!logger::read_flight_recorder(std::filesystem::path{argv[1]}, count, records))
+	{
+		fprintf(stderr, "Not a flight recorder file: %s\n", argv[1]);
+		return 1;
+	}
+
+	for(std::u8string const& record: records)
+	{
+		fwrite(record.data(), 1, record.size(), stdout);
+	}
+	return 0;
+}
@@ -29,6 +29,9 @@
 
 #include "Logger_client.hpp"
 #include "toLog/log_streamer.hpp"
+#include "toLog/log_filter_cache.hpp"
+#include "toLog/log_rate_limit.hpp"
+#include "toLog/log_kv.hpp"
 
 #include <LogLib/logger_struct.hpp>
 
@@ -46,42 +49,157 @@
 #define __LOG_FILE __FILE__
 #endif
 
-#define LOG_CUSTOM(File, Line, Column, _Level, ...) \
+#ifdef LOGGER_DEFERRED_FORMAT
+/// \brief Only captures the arguments in binary form, formatting is delegated to the logger or sinks (see \ref log_sink::accepts_deferred)
+#	define _P_LOG_DISPATCH ::logger::_p::log_deferred
+#else
+#	define _P_LOG_DISPATCH ::logger::_p::log_render
+#endif
+
+/// \brief Generates a log if it passes the filter and Gate evaluates to true, Gate is only evaluated after the filter
+/// \param[in] Dispatch - Function that receives the log data followed by the arguments
+#define _P_LOG_GATED(File, Line, Column, _Level, Gate, Dispatch, ...) \
 	{ \
-		::logger::log_message_data _P_BASE_LOG_DATA; \
-		_P_BASE_LOG_DATA.module_base = ::core::get_current_module_base(); \
-		_P_BASE_LOG_DATA.user_token  = nullptr; \
-		_P_BASE_LOG_DATA.module_name = ::core::get_current_module_name(); \
-		_P_BASE_LOG_DATA.file        = ::core::os_string_view{__LOG_FILE}; \
-		_P_BASE_LOG_DATA.line        = static_cast<uint32_t>(__LINE__); \
-		_P_BASE_LOG_DATA.column      = 0; \
-		_P_BASE_LOG_DATA.level       = _Level; \
-		if(::logger::_p::log_check_filter(_P_BASE_LOG_DATA)) \
+		static constexpr ::logger::log_site _P_LOG_SITE{::core::os_string_view{__LOG_FILE}, static_cast<uint32_t>(__LINE__)}; \
+		static constinit ::logger::_p::filter_cache _P_LOG_FILTER{0}; \
+		::logger::Level const _P_LOG_LEVEL = _Level; \
+		if(::logger::_p::filter_cache_check(_P_LOG_FILTER, _P_LOG_SITE, _P_LOG_LEVEL, &::logger::_p::this_module) && (Gate)) \
 		{ \
-			_P_BASE_LOG_DATA.file   = File; \
-			_P_BASE_LOG_DATA.line   = Line; \
-			_P_BASE_LOG_DATA.column = Column; \
-			core::print<char8_t>(::logger::_p::LogStreamer(_P_BASE_LOG_DATA) __VA_OPT__(,) __VA_ARGS__); \
+			::logger::log_module const& _P_LOG_MODULE = ::logger::_p::this_module(); \
+			::logger::log_message_data _P_BASE_LOG_DATA; \
+			_P_BASE_LOG_DATA.site        = &_P_LOG_SITE; \
+			_P_BASE_LOG_DATA.module_base = _P_LOG_MODULE.base; \
+			_P_BASE_LOG_DATA.user_token  = nullptr; \
+			_P_BASE_LOG_DATA.module_name = _P_LOG_MODULE.name; \
+			_P_BASE_LOG_DATA.file        = File; \
+			_P_BASE_LOG_DATA.line        = Line; \
+			_P_BASE_LOG_DATA.column      = Column; \
+			_P_BASE_LOG_DATA.level       = _P_LOG_LEVEL; \
+			Dispatch(_P_BASE_LOG_DATA __VA_OPT__(,) __VA_ARGS__); \
 		} \
 	}
 
+#define LOG_CUSTOM(File, Line, Column, _Level, ...) _P_LOG_GATED(File, Line, Column, _Level, true, _P_LOG_DISPATCH __VA_OPT__(,) __VA_ARGS__)
+
 /// \brief Helper Macro to assist on message formating and automatically filling of __FILE__ (__FILEW__ on windows) and __LINE__
 /// \param[in] Level - \ref logger::Level
 #define LOG_MESSAGE(Level, ...) LOG_CUSTOM(::core::os_string_view{__LOG_FILE}, static_cast<uint32_t>(__LINE__), 0, Level, __VA_ARGS__)
 
-/// \brief Helper Macro for info logs
-#define LOG_INFO(...)		LOG_MESSAGE(::logger::Level::Info, __VA_ARGS__)
+#define _P_LOG_MESSAGE_GATED(Level, Gate, ...) _P_LOG_GATED(::core::os_string_view{__LOG_FILE}, static_cast<uint32_t>(__LINE__), 0, Level, Gate, _P_LOG_DISPATCH __VA_OPT__(,) __VA_ARGS__)
 
-/// \brief Helper Macro for warning logs
-#define LOG_WARNING(...)	LOG_MESSAGE(::logger::Level::Warning, __VA_ARGS__)
+//======== ======== Rate limiting and sampling ======== ========
+//	The state is kept per call site and is only updated by logs that pass the filter.
 
-/// \brief Helper Macro for error logs
-#define LOG_ERROR(...)		LOG_MESSAGE(::logger::Level::Error, __VA_ARGS__)
+/// \brief Logs the 1st, N+1th, 2N+1th, ... occurrences
+/// \param[in] N - Period, must not be 0
+#define LOG_EVERY_N(Level, N, ...) \
+	{ \
+		static constinit ::logger::_p::log_counter _P_LOG_COUNTER{0}; \
+		_P_LOG_MESSAGE_GATED(Level, ::logger::_p::log_every_n(_P_LOG_COUNTER, N) __VA_OPT__(,) __VA_ARGS__) \
+	}
+
+/// \brief Logs only the first N occurrences
+#define LOG_FIRST_N(Level, N, ...) \
+	{ \
+		static constinit ::logger::_p::log_counter _P_LOG_COUNTER{0}; \
+		_P_LOG_MESSAGE_GATED(Level, ::logger::_p::log_first_n(_P_LOG_COUNTER, N) __VA_OPT__(,) __VA_ARGS__) \
+	}
+
+/// \brief Logs only the first occurrence
+#define LOG_ONCE(Level, ...) \
+	{ \
+		static constinit ::logger::_p::log_once_flag _P_LOG_ONCE_FLAG{false}; \
+		_P_LOG_MESSAGE_GATED(Level, ::logger::_p::log_once(_P_LOG_ONCE_FLAG) __VA_OPT__(,) __VA_ARGS__) \
+	}
+
+/// \brief Token bucket rate limiting, allows bursts of up to Burst logs, sustained at PerSecond logs per second
+#define LOG_RATE_LIMITED(Level, PerSecond, Burst, ...) \
+	{ \
+		static constinit ::logger::_p::log_rate_bucket _P_LOG_BUCKET{0}; \
+		_P_LOG_MESSAGE_GATED(Level, ::logger::_p::log_rate_limit(_P_LOG_BUCKET, PerSecond, Burst) __VA_OPT__(,) __VA_ARGS__) \
+	}
+
+/// \brief Logs each occurrence with a given probability
+/// \param[in] Probability - Value in the range [0, 1]
+#define LOG_SAMPLED(Level, Probability, ...) _P_LOG_MESSAGE_GATED(Level, ::logger::_p::log_sample(Probability) __VA_OPT__(,) __VA_ARGS__)
+
+//======== ======== Structured logs ======== ========
+
+/// \brief Generates a structured log (see \ref log_kv.hpp), ex. LOG_MESSAGE_KV(Level, "Request done"sv, "user"sv, id, "latency_us"sv, t)
+/// \param[in] Message - String describing the event
+/// \param[in] ... - Pairs of string keys and values (numbers, characters, or strings)
+#define LOG_MESSAGE_KV(Level, Message, ...) _P_LOG_GATED(::core::os_string_view{__LOG_FILE}, static_cast<uint32_t>(__LINE__), 0, Level, true, ::logger::_p::log_kv, Message __VA_OPT__(,) __VA_ARGS__)
+
+//======== ======== Compile time level threshold ======== ========
 
-#ifdef _DEBUG
-/// \brief Helper Macro for debug logs. If built in debug mode, message will be logged, if built in release the Macro will automatically eliminate the lines of code.
+#define LOGGER_LEVEL_TRACE		0
+#define LOGGER_LEVEL_VERBOSE	1
+#define LOGGER_LEVEL_DEBUG		2
+#define LOGGER_LEVEL_INFO		3
+#define LOGGER_LEVEL_WARNING	4
+#define LOGGER_LEVEL_ERROR		5
+
+/// \brief Logs with a level bellow this threshold are eliminated at compile time, arguments are not evaluated.
+///	Can be defined before including this header (or as a build flag) to one of the LOGGER_LEVEL_* values.
+///	By default, debug builds keep all logs, release builds eliminate Debug, Verbose, and Trace logs.
+#ifndef LOGGER_MIN_LEVEL
+#	ifdef _DEBUG
+#		define LOGGER_MIN_LEVEL LOGGER_LEVEL_TRACE
+#	else
+#		define LOGGER_MIN_LEVEL LOGGER_LEVEL_INFO
+#	endif
+#endif
+
+#if LOGGER_MIN_LEVEL <= LOGGER_LEVEL_TRACE
+/// \brief Helper Macro for trace logs
+#	define LOG_TRACE(...)	LOG_MESSAGE(::logger::Level::Trace, __VA_ARGS__)
+#	define LOG_TRACE_KV(...)	LOG_MESSAGE_KV(::logger::Level::Trace, __VA_ARGS__)
+#else
+#	define LOG_TRACE(...)	::logger::_p::no_op();
+#	define LOG_TRACE_KV(...)	::logger::_p::no_op();
+#endif
+
+#if LOGGER_MIN_LEVEL <= LOGGER_LEVEL_VERBOSE
+/// \brief Helper Macro for verbose logs
+#	define LOG_VERBOSE(...)	LOG_MESSAGE(::logger::Level::Verbose, __VA_ARGS__)
+#	define LOG_VERBOSE_KV(...)	LOG_MESSAGE_KV(::logger::Level::Verbose, __VA_ARGS__)
+#else
+#	define LOG_VERBOSE(...)	::logger::_p::no_op();
+#	define LOG_VERBOSE_KV(...)	::logger::_p::no_op();
+#endif
+
+#if LOGGER_MIN_LEVEL <= LOGGER_LEVEL_DEBUG
+/// \brief Helper Macro for debug logs
 #	define LOG_DEBUG(...)	LOG_MESSAGE(::logger::Level::Debug, __VA_ARGS__)
+#	define LOG_DEBUG_KV(...)	LOG_MESSAGE_KV(::logger::Level::Debug, __VA_ARGS__)
 #else
-/// \brief Helper Macro for debug logs. If built in debug mode, message will be logged, if built in release the Macro will automatically eliminate the lines of code.
 #	define LOG_DEBUG(...)	::logger::_p::no_op();
+#	define LOG_DEBUG_KV(...)	::logger::_p::no_op();
+#endif
+
+#if LOGGER_MIN_LEVEL <= LOGGER_LEVEL_INFO
+/// \brief Helper Macro for info logs
+#	define LOG_INFO(...)	LOG_MESSAGE(::logger::Level::Info, __VA_ARGS__)
+#	define LOG_INFO_KV(...)	LOG_MESSAGE_KV(::logger::Level::Info, __VA_ARGS__)
+#else
+#	define LOG_INFO(...)	::logger::_p::no_op();
+#	define LOG_INFO_KV(...)	::logger::_p::no_op();
+#endif
+
+#if LOGGER_MIN_LEVEL <= LOGGER_LEVEL_WARNING
+/// \brief Helper Macro for warning logs
+#	define LOG_WARNING(...)	LOG_MESSAGE(::logger::Level::Warning, __VA_ARGS__)
+#	define LOG_WARNING_KV(...)	LOG_MESSAGE_KV(::logger::Level::Warning, __VA_ARGS__)
+#else
+#	define LOG_WARNING(...)	::logger::_p::no_op();
+#	define LOG_WARNING_KV(...)	::logger::_p::no_op();
+#endif
+
+#if LOGGER_MIN_LEVEL <= LOGGER_LEVEL_ERROR
+/// \brief Helper Macro for error logs
+#	define LOG_ERROR(...)	LOG_MESSAGE(::logger::Level::Error, __VA_ARGS__)
+#	define LOG_ERROR_KV(...)	LOG_MESSAGE_KV(::logger::Level::Error, __VA_ARGS__)
+#else
+#	define LOG_ERROR(...)	::logger::_p::no_op();
+#	define LOG_ERROR_KV(...)	::logger::_p::no_op();
 #endif
@@ -28,12 +28,16 @@
 #pragma once
 
 #include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <span>
 #include <string_view>
 
 #include <CoreLib/string/core_os_string.hpp>
 
 #include <LogLib/logger_struct.hpp>
 #include <LogLib/log_level.hpp>
+#include <LogLib/log_scratch.hpp>
 
 #include "Logger_api.h"
 
@@ -45,10 +49,59 @@ namespace logger
 ///	\brief Public interface for logging
 Logger_API void log_message(log_message_data const& data, std::u8string_view message);
 
+///	\brief Public interface for logging, the message is rendered directly into the memory of the sinks when possible
+Logger_API void log_message(log_message_data const& data, log_message_source const& message);
+
+///	\brief Public interface for logging multiple messages at once
+Logger_API void log_message_batch(std::span<log_message_record const> records);
+
+///	\brief Public interface for logging with deferred formatting
+///	\param[in] record - Message arguments encoded as described in <LogLib/log_deferred.hpp>
+Logger_API void log_message_deferred(log_message_data const& data, std::span<std::byte const> record);
+
+///	\brief Public interface for structured logging
+///	\param[in] record - Message and fields encoded as described in <LogLib/log_kv.hpp>
+Logger_API void log_message_kv(log_message_data const& data, std::span<std::byte const> record);
+
 namespace _p
 {
 	///	\brief Public interface for log filtering
 	[[nodiscard]] Logger_API bool log_check_filter(log_filter_data const& data);
+
+	///	\brief Incremented every time the filter changes, invalidating the verdicts cached by the call sites
+	extern Logger_API std::atomic<uint32_t> g_filter_generation;
+
+	///	\brief Acquires a buffer from the scratch arena of the logger (the one reserved by log_prepare_thread),
+	///		each module would otherwise have its own copy of the thread local arena.
+	///	\param[out] p_marker - State of the arena to be restored by \ref log_scratch_release
+	[[nodiscard]] Logger_API std::byte* log_scratch_acquire(uintptr_t p_size, scratch_arena::marker& p_marker);
+
+	///	\brief Releases a buffer from \ref log_scratch_acquire, in the reverse order they were acquired
+	Logger_API void log_scratch_release(scratch_arena::marker p_marker);
+
+	///	\brief Equivalent of \ref log_scratch for code compiled into the modules that log
+	class client_scratch
+	{
+	public:
+		client_scratch(uintptr_t const p_size)
+			: m_data(log_scratch_acquire(p_size, m_marker))
+		{
+		}
+
+		~client_scratch()
+		{
+			log_scratch_release(m_marker);
+		}
+
+		client_scratch(client_scratch const&) = delete;
+		client_scratch& operator = (client_scratch const&) = delete;
+
+		[[nodiscard]] inline std::byte* data() const { return m_data; }
+
+	private:
+		scratch_arena::marker m_marker;
+		std::byte* const m_data;
+	};
 } //namespace _p
 
 } //namespace logger
\ No newline at end of file
@@ -27,6 +27,8 @@
 
 #pragma once
 
+#include <cstdint>
+
 #include "Logger_api.h"
 
 
@@ -37,11 +39,22 @@ namespace logger
 
 class log_sink;
 class log_filter;
+struct log_sink_filter;
 
 Logger_API void log_add_sink   (log_sink& p_stream);
+Logger_API void log_add_sink   (log_sink& p_stream, log_sink_filter const& p_filter);
 Logger_API void log_remove_sink(log_sink& p_stream);
 Logger_API void log_remove_all ();
 
+///	\brief Changes the restrictions of a registered sink
+///	\return false if the sink is not registered
+Logger_API bool log_set_sink_filter(log_sink& p_stream, log_sink_filter const& p_filter);
+
+///	\brief Allocates ahead of time the resources the calling thread needs to log to the registered sinks.
+///		Once a thread is prepared, logging does not allocate memory, unless the sinks change or a record larger than p_scratch_size is logged.
+///	\param[in] p_scratch_size - Size in bytes of the largest record expected to be logged by the thread
+Logger_API void log_prepare_thread(uintptr_t p_scratch_size = 0);
+
 Logger_API void log_set_filter  (log_filter const& p_filter);
 Logger_API void log_reset_filter(bool p_default_behaviour);
 
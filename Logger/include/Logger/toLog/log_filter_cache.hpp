@@ -0,0 +1,89 @@
+//======== ======== ======== ======== ======== ======== ======== ========
+///	\file
+///
+///	\copyright
+///		Copyright (c) Tiago Miguel Oliveira Freire
+///
+///		Permission is hereby granted, free of charge, to any person obtaining a copy
+///		of this software and associated documentation files (the "Software"),
+///		to copy, modify, publish, and/or distribute copies of the Software,
+///		and to permit persons to whom the Software is furnished to do so,
+///		subject to the following conditions:
+///
+///		The copyright notice and this permission notice shall be included in all
+///		copies or substantial portions of the Software.
+///		The copyrighted work, or derived works, shall not be used to train
+///		Artificial Intelligence models of any sort; or otherwise be used in a
+///		transformative way that could obfuscate the source of the copyright.
+///
+///		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+///		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+///		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+///		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+///		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+///		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+///		SOFTWARE.
+//======== ======== ======== ======== ======== ======== ======== ========
+
+
+#pragma once
+
+#include <cstdint>
+#include <atomic>
+
+#include <CoreLib/core_extra_compiler.hpp>
+
+#include <LogLib/logger_struct.hpp>
+#include <LogLib/log_level.hpp>
+
+#include <Logger/Logger_client.hpp>
+
+#include "log_streamer.hpp"
+
+namespace logger::_p
+{
+	///	\brief Per call site cache of the filter verdict.
+	///	\note Layout is [generation:32][level:8][unused:22][valid:1][verdict:1]
+	using filter_cache = std::atomic<uint64_t>;
+
+	inline constexpr uint64_t filter_cache_key(uint32_t const p_generation, Level const p_level)
+	{
+		return (uint64_t{p_generation} << 32) | (uint64_t{static_cast<uint8_t>(p_level)} << 24) | 0x02;
+	}
+
+	///	\brief Returns the module of the call site, \ref this_module of the translation unit of the call site
+	using log_module_getter = log_module const& (*)();
+
+	///	\brief Evaluates the filter for the call site and caches the result
+	///	\note Shared by every module, the module of the call site is provided by p_module
+	inline NO_INLINE bool filter_cache_refresh(filter_cache& p_cache, log_site const& p_site, Level const p_level, log_module_getter const p_module)
+	{
+		uint32_t const generation = g_filter_generation.load(std::memory_order::acquire);
+
+		log_module const& module = p_module();
+		log_filter_data data;
+		data.site        = &p_site;
+		data.module_base = module.base;
+		data.user_token  = nullptr;
+		data.module_name = module.name;
+		data.file        = p_site.file;
+		data.line        = p_site.line;
+		data.column      = 0;
+		data.level       = p_level;
+
+		bool const verdict = log_check_filter(data);
+		p_cache.store(filter_cache_key(generation, p_level) | (verdict ? 1 : 0), std::memory_order::relaxed);
+		return verdict;
+	}
+
+	///	\brief Checks if a call site is accepted by the filter, only calls the filter if the cached verdict is no longer valid
+	[[nodiscard]] inline bool filter_cache_check(filter_cache& p_cache, log_site const& p_site, Level const p_level, log_module_getter const p_module)
+	{
+		uint64_t const state = p_cache.load(std::memory_order::relaxed);
+		if((state & ~uint64_t{1}) == filter_cache_key(g_filter_generation.load(std::memory_order::relaxed), p_level)) [[likely]]
+		{
+			return state & 1;
+		}
+		return filter_cache_refresh(p_cache, p_site, p_level, p_module);
+	}
+} //namespace logger::_p
@@ -0,0 +1,111 @@
+//======== ======== ======== ======== ======== ======== ======== ========
+///	\file
+///
+///	\copyright
+///		Copyright (c) Tiago Miguel Oliveira Freire
+///
+///		Permission is hereby granted, free of charge, to any person obtaining a copy
+///		of this software and associated documentation files (the "Software"),
+///		to copy, modify, publish, and/or distribute copies of the Software,
+///		and to permit persons to whom the Software is furnished to do so,
+///		subject to the following conditions:
+///
+///		The copyright notice and this permission notice shall be included in all
+///		copies or substantial portions of the Software.
+///		The copyrighted work, or derived works, shall not be used to train
+///		Artificial Intelligence models of any sort; or otherwise be used in a
+///		transformative way that could obfuscate the source of the copyright.
+///
+///		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+///		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+///		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+///		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+///		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+///		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+///		SOFTWARE.
+//======== ======== ======== ======== ======== ======== ======== ========
+
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include <CoreLib/core_alloca.hpp>
+
+#include <LogLib/log_deferred.hpp>
+#include <LogLib/logger_struct.hpp>
+
+#include <Logger/Logger_client.hpp>
+
+namespace logger::_p
+{
+	///	\brief Converts string literals and null terminated strings to string views, other values are used as is
+	template<typename T>
+	inline T const& kv_value(T const& p_val) { return p_val; }
+
+	template<typename C> requires (std::is_same_v<C, char> || std::is_same_v<C, char8_t>)
+	inline std::basic_string_view<C> kv_value(C const* const p_str) { return std::basic_string_view<C>{p_str}; }
+
+	template<typename T>
+	using kv_value_t = std::remove_cvref_t<decltype(kv_value(std::declval<T const&>()))>;
+
+	template<typename T>
+	constexpr bool is_kv_key_v =
+		std::is_same_v<T, std::string_view> || std::is_same_v<T, std::u8string_view> ||
+		std::is_same_v<T, std::string> || std::is_same_v<T, std::u8string>;
+
+	template<typename... Args>
+	consteval bool kv_pairs_valid();
+
+	template<typename Key, typename Value, typename... Args>
+	consteval bool kv_pairs_check()
+	{
+		return is_kv_key_v<kv_value_t<Key>> && is_deferred_encodable_v<kv_value_t<Value>> && kv_pairs_valid<Args...>();
+	}
+
+	template<typename... Args>
+	consteval bool kv_pairs_valid()
+	{
+		if constexpr(sizeof...(Args) == 0)
+		{
+			return true;
+		}
+		else if constexpr(sizeof...(Args) % 2 != 0)
+		{
+			return false;
+		}
+		else
+		{
+			return kv_pairs_check<Args...>();
+		}
+	}
+
+	///	\brief Encodes a structured log (see <LogLib/log_kv.hpp>) and sends it to the logger
+	template<typename Message, typename... Args>
+	inline void log_kv(log_message_data const& p_data, Message const& p_message, Args const&... p_args)
+	{
+		static_assert(is_kv_key_v<kv_value_t<Message>>, "The message of a structured log must be a string");
+		static_assert(kv_pairs_valid<Args...>(), "Fields must be given as pairs of string keys and values that are numbers, characters, or strings");
+
+		uintptr_t const size = deferred_encode_size(kv_value(p_message), kv_value(p_args)...);
+		constexpr uintptr_t alloca_treshold = 0x10000;
+
+		if(size > alloca_treshold)
+		{
+			client_scratch const buff{size};
+			deferred_encode(buff.data(), kv_value(p_message), kv_value(p_args)...);
+			::logger::log_message_kv(p_data, std::span<std::byte const>{buff.data(), size});
+		}
+		else
+		{
+			std::byte* const buff = reinterpret_cast<std::byte*>(core_alloca(size));
+			deferred_encode(buff, kv_value(p_message), kv_value(p_args)...);
+			::logger::log_message_kv(p_data, std::span<std::byte const>{buff, size});
+		}
+	}
+} //namespace logger::_p
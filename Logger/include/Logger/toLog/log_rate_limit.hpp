@@ -0,0 +1,134 @@
+//======== ======== ======== ======== ======== ======== ======== ========
+///	\file
+///
+///	\copyright
+///		Copyright (c) Tiago Miguel Oliveira Freire
+///
+///		Permission is hereby granted, free of charge, to any person obtaining a copy
+///		of this software and associated documentation files (the "Software"),
+///		to copy, modify, publish, and/or distribute copies of the Software,
+///		and to permit persons to whom the Software is furnished to do so,
+///		subject to the following conditions:
+///
+///		The copyright notice and this permission notice shall be included in all
+///		copies or substantial portions of the Software.
+///		The copyrighted work, or derived works, shall not be used to train
+///		Artificial Intelligence models of any sort; or otherwise be used in a
+///		transformative way that could obfuscate the source of the copyright.
+///
+///		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+///		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+///		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+///		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+///		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+///		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+///		SOFTWARE.
+//======== ======== ======== ======== ======== ======== ======== ========
+
+
+#pragma once
+
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+
+#include <CoreLib/core_extra_compiler.hpp>
+
+namespace logger::_p
+{
+	///	\brief Per call site counter used by LOG_EVERY_N and LOG_FIRST_N
+	using log_counter = std::atomic<uint64_t>;
+
+	///	\brief Per call site flag used by LOG_ONCE
+	using log_once_flag = std::atomic<bool>;
+
+	///	\brief Per call site token bucket used by LOG_RATE_LIMITED.
+	///	\note Stored as the theoretical arrival time of the next log (in steady clock nanoseconds),
+	///		which makes the bucket a single word that can be updated with a compare exchange.
+	using log_rate_bucket = std::atomic<int64_t>;
+
+	///	\brief Accepts the 1st, N+1th, 2N+1th, ... occurrences
+	[[nodiscard]] inline bool log_every_n(log_counter& p_counter, uint64_t const p_n)
+	{
+		return p_counter.fetch_add(1, std::memory_order::relaxed) % p_n == 0;
+	}
+
+	///	\brief Accepts only the first N occurrences
+	[[nodiscard]] inline bool log_first_n(log_counter& p_counter, uint64_t const p_n)
+	{
+		//once exhausted the counter is only read, avoiding contention on the cache line
+		if(p_counter.load(std::memory_order::relaxed) >= p_n) [[likely]]
+		{
+			return false;
+		}
+		return p_counter.fetch_add(1, std::memory_order::relaxed) < p_n;
+	}
+
+	///	\brief Accepts only the first occurrence
+	[[nodiscard]] inline bool log_once(log_once_flag& p_flag)
+	{
+		return !p_flag.load(std::memory_order::relaxed) && !p_flag.exchange(true, std::memory_order::relaxed);
+	}
+
+	///	\brief Token bucket, accepts up to p_burst occurrences at once, refilled at a rate of p_per_second
+	inline NO_INLINE bool log_rate_limit(log_rate_bucket& p_bucket, uint32_t const p_per_second, uint32_t const p_burst)
+	{
+		if(p_per_second == 0)
+		{
+			return false;
+		}
+
+		int64_t const now = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		int64_t const interval  = 1'000'000'000 / static_cast<int64_t>(p_per_second);
+		int64_t const tolerance = interval * static_cast<int64_t>(p_burst > 1 ? p_burst - 1 : 0);
+
+		int64_t arrival = p_bucket.load(std::memory_order::relaxed);
+		while(true)
+		{
+			int64_t const start = arrival < now ? now : arrival;
+			if(start - now > tolerance)
+			{
+				return false;
+			}
+			if(p_bucket.compare_exchange_weak(arrival, start + interval, std::memory_order::relaxed))
+			{
+				return true;
+			}
+		}
+	}
+
+	///	\brief Thread local xorshift generator used for sampling
+	inline uint64_t log_sample_random()
+	{
+		thread_local uint64_t state = 0;
+		if(state == 0) [[unlikely]]
+		{
+			//splitmix64 of the address of the state (distinct per thread) and the current time
+			uint64_t seed = reinterpret_cast<uintptr_t>(&state) ^ static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+			seed += 0x9E3779B97F4A7C15ull;
+			seed = (seed ^ (seed >> 30)) * 0xBF58476D1CE4E5B9ull;
+			seed = (seed ^ (seed >> 27)) * 0x94D049BB133111EBull;
+			seed ^= seed >> 31;
+			state = seed ? seed : 1;
+		}
+		state ^= state << 13;
+		state ^= state >> 7;
+		state ^= state << 17;
+		return state;
+	}
+
+	///	\brief Accepts an occurrence with probability p_probability [0, 1]
+	[[nodiscard]] inline bool log_sample(double const p_probability)
+	{
+		if(p_probability >= 1.0)
+		{
+			return true;
+		}
+		if(!(p_probability > 0.0))
+		{
+			return false;
+		}
+		//53 bits, exactly representable as a double
+		return static_cast<double>(log_sample_random() >> 11) < p_probability * 9007199254740992.0;
+	}
+} //namespace logger::_p
@@ -28,34 +28,117 @@
 #pragma once
 
 #include <cstdint>
+#include <cstddef>
+#include <span>
 #include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 
-#include <CoreLib/toPrint/toPrint_sink.hpp>
+#include <CoreLib/toPrint/toPrint.hpp>
+#include <CoreLib/core_alloca.hpp>
+#include <CoreLib/core_module.hpp>
 
 #include <LogLib/log_level.hpp>
+#include <LogLib/log_deferred.hpp>
 
 #include <Logger/Logger_client.hpp>
 
 namespace logger::_p
 {
-	class LogStreamer: public core::sink_toPrint_base
+	///	\brief Adapter used to print an argument, arguments that are already adapters are used as is
+	template<typename T>
+	struct printer
 	{
-	private:
-		log_message_data const& m_data;
+		using type = core::toPrint<T>;
+	};
+
+	template<typename T> requires std::is_base_of_v<core::toPrint_base, T>
+	struct printer<T>
+	{
+		using type = T const&;
+	};
+
+	///	\brief String literals
+	template<typename C, std::size_t N> requires (std::is_same_v<C, char> || std::is_same_v<C, char8_t>)
+	struct printer<C[N]>
+	{
+		using type = core::toPrint<std::basic_string_view<C>>;
+	};
+
+	template<typename T>
+	using printer_t = typename printer<std::remove_cv_t<T>>::type;
 
+	///	\brief Renders the arguments of a log directly into the memory provided by the logger or the sinks
+	template<typename... Args>
+	class message_printer final: public log_message_source
+	{
 	public:
-		constexpr inline LogStreamer(
-			log_message_data const& data)
-			: m_data	(data)
+		message_printer(Args const&... p_args)
+			: m_printers(p_args...)
 		{
+			m_size = std::apply(
+				[](auto const&... p_printer)
+				{
+					return (uintptr_t{0} + ... + p_printer.size(char8_t{}));
+				}, m_printers);
 		}
 
-		void write(const std::u8string_view p_message) const
+		void render(char8_t* p_out) const final
 		{
-			::logger::log_message(m_data, p_message);
+			std::apply(
+				[&p_out](auto const&... p_printer)
+				{
+					((p_printer.get_print(p_out), p_out += p_printer.size(char8_t{})), ...);
+				}, m_printers);
 		}
+
+	private:
+		std::tuple<printer_t<Args>...> const m_printers;
 	};
 
+	template<typename... Args>
+	inline void log_render(log_message_data const& p_data, Args const&... p_args)
+	{
+		::logger::log_message(p_data, message_printer<Args...>{p_args...});
+	}
+
+	///	\brief Captures the arguments in binary form and delegates their formatting to the logger (or the sinks).
+	///		Falls back to regular formatting if any of the arguments can not be captured.
+	template<typename... Args>
+	inline void log_deferred(log_message_data const& p_data, Args const&... p_args)
+	{
+		if constexpr(is_deferred_encodable_v<Args...>)
+		{
+			uintptr_t const size = deferred_encode_size(p_args...);
+			constexpr uintptr_t alloca_treshold = 0x10000;
+
+			if(size > alloca_treshold)
+			{
+				client_scratch const buff{size};
+				deferred_encode(buff.data(), p_args...);
+				::logger::log_message_deferred(p_data, std::span<std::byte const>{buff.data(), size});
+			}
+			else
+			{
+				std::byte* const buff = reinterpret_cast<std::byte*>(core_alloca(size));
+				deferred_encode(buff, p_args...);
+				::logger::log_message_deferred(p_data, std::span<std::byte const>{buff, size});
+			}
+		}
+		else
+		{
+			log_render(p_data, p_args...);
+		}
+	}
+
+	///	\brief Information of the module being compiled, resolved only once per translation unit
+	static inline log_module const& this_module()
+	{
+		static log_module const module{::core::get_current_module_base(), ::core::get_current_module_name()};
+		return module;
+	}
+
 	inline constexpr void no_op() {}
 } //namespace logger::_p
 
@@ -32,6 +32,7 @@
 
 #include <LogLib/logger_struct.hpp>
 #include <LogLib/log_filter.hpp>
+#include <LogLib/log_kv.hpp>
 #include <LogLib/logger_group.hpp>
 
 #include <Logger/Logger_client.hpp>
@@ -49,19 +50,46 @@ static bool g_default_filter_behaviour = true;
 
 //======== ======== ======== ======== Public API ======== ======== ======== ========
 
+//logs cached as rejected by the call sites may now be accepted by a sink
+static void invalidate_filter_cache()
+{
+	_p::g_filter_generation.fetch_add(1, std::memory_order::acq_rel);
+}
+
 Logger_API void log_add_sink(log_sink& p_stream)
 {
 	g_logger.add_sink(p_stream);
+	invalidate_filter_cache();
+}
+
+Logger_API void log_add_sink(log_sink& p_stream, log_sink_filter const& p_filter)
+{
+	g_logger.add_sink(p_stream, p_filter);
+	invalidate_filter_cache();
 }
 
 Logger_API void log_remove_sink(log_sink& p_stream)
 {
 	g_logger.remove_sink(p_stream);
+	invalidate_filter_cache();
 }
 
 Logger_API void log_remove_all()
 {
 	g_logger.clear();
+	invalidate_filter_cache();
+}
+
+Logger_API void log_prepare_thread(uintptr_t const p_scratch_size)
+{
+	g_logger.prepare_thread(p_scratch_size);
+}
+
+Logger_API bool log_set_sink_filter(log_sink& p_stream, log_sink_filter const& p_filter)
+{
+	bool const found = g_logger.set_sink_filter(p_stream, p_filter);
+	invalidate_filter_cache();
+	return found;
 }
 
 Logger_API void log_message(log_message_data const& data, std::u8string_view message)
@@ -69,22 +97,55 @@ Logger_API void log_message(log_message_data const& data, std::u8string_view mes
 	g_logger.log(data, message);
 }
 
+Logger_API void log_message(log_message_data const& data, log_message_source const& message)
+{
+	g_logger.log(data, message);
+}
+
+Logger_API void log_message_batch(std::span<log_message_record const> records)
+{
+	g_logger.log_batch(records);
+}
+
+Logger_API void log_message_deferred(log_message_data const& data, std::span<std::byte const> record)
+{
+	g_logger.log_deferred(data, record);
+}
+
+Logger_API void log_message_kv(log_message_data const& data, std::span<std::byte const> record)
+{
+	log_message_data kv_data = data;
+	kv_data.kv = record;
+	g_logger.log(kv_data, log_kv_source{record});
+}
+
 Logger_API void log_set_filter(log_filter const& p_filter)
 {
 	g_filter = &p_filter;
+	invalidate_filter_cache();
 }
 
 Logger_API void log_reset_filter(bool p_default_behaviour)
 {
 	g_filter = nullptr;
 	g_default_filter_behaviour = p_default_behaviour;
+	invalidate_filter_cache();
 }
 
 namespace _p
 {
 
+//starts at 1 so that a zero initialized cache is never valid
+Logger_API std::atomic<uint32_t> g_filter_generation = 1;
+
 Logger_API bool log_check_filter(log_filter_data const& p_data)
 {
+	//no need to consult the user filter if no sink would accept the log
+	if(!g_logger.accepts(p_data.level, p_data.module_base))
+	{
+		return false;
+	}
+
 	if(g_filter)
 	{
 		return g_filter->filter(p_data);
@@ -92,6 +153,18 @@ Logger_API bool log_check_filter(log_filter_data const& p_data)
 	return g_default_filter_behaviour;
 }
 
+Logger_API std::byte* log_scratch_acquire(uintptr_t const p_size, scratch_arena::marker& p_marker)
+{
+	scratch_arena& arena = scratch_arena::local();
+	p_marker = arena.mark();
+	return arena.acquire(p_size);
+}
+
+Logger_API void log_scratch_release(scratch_arena::marker const p_marker)
+{
+	scratch_arena::local().release(p_marker);
+}
+
 } //namespace _p
 
 }// namespace logger
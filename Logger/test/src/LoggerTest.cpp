@@ -28,6 +28,22 @@
 #include <iostream>
 #include <vector>
 #include <array>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <limits>
+#include <algorithm>
+
+#ifdef __linux__
+#	include <fcntl.h>
+#	include <unistd.h>
+#endif
 
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
@@ -35,13 +51,106 @@
 #include <CoreLib/core_thread.hpp>
 #include <CoreLib/core_type.hpp>
 #include <CoreLib/core_module.hpp>
+#include <CoreLib/core_extra_compiler.hpp>
 
 #include <Logger/Logger.hpp>
 #include <Logger/Logger_service.hpp>
 #include <LogLib/sink/log_sink.hpp>
+#include <LogLib/log_filter.hpp>
+#include <LogLib/log_rule_filter.hpp>
+#include <LogLib/log_kv.hpp>
+#include <LogLib/log_clock.hpp>
+#include <LogLib/log_flight_recorder.hpp>
+#include <LogLib/sink/log_flight_recorder_sink.hpp>
+#include <LogLib/sink/log_async_file_sink.hpp>
+#include <LogLib/log_ring_buffer.hpp>
+#include <LogLib/log_record_pool.hpp>
+#include <LogLib/sink/log_flush_policy.hpp>
+#include <LogLib/sink/log_uring_writer.hpp>
+#include <LogLib/sink/log_direct_writer.hpp>
+#include <LogLib/sink/log_mmap_file_sink.hpp>
+#include <LogLib/sink/log_rotating_file_sink.hpp>
+#include <LogLib/sink/log_file_sink.hpp>
+#include <LogLib/sink/log_console_sink.hpp>
 
 using namespace core::literals;
 
+//======== ======== Allocation tracking ======== ========
+//	Only counts allocations made by this module (on platforms where the Logger is a separate library
+//	its own allocations are not visible), and only while enabled on the current thread.
+
+static thread_local bool t_track_allocations = false;
+static thread_local uint32_t t_allocations = 0;
+
+static void* tracked_alloc(std::size_t const p_size, std::size_t const p_alignment)
+{
+	if(t_track_allocations)
+	{
+		++t_allocations;
+	}
+	std::size_t const size = p_size ? p_size : 1;
+#ifdef _WIN32
+	void* const res = _aligned_malloc(size, p_alignment);
+#else
+	//aligned_alloc requires the size to be a multiple of the alignment
+	void* const res = std::aligned_alloc(p_alignment, (size + p_alignment - 1) & ~(p_alignment - 1));
+#endif
+	if(res == nullptr)
+	{
+		throw std::bad_alloc{};
+	}
+	return res;
+}
+
+//not inlined, the compiler would otherwise see the memory from operator new being given to free
+static NO_INLINE void tracked_free(void* const p_ptr) noexcept
+{
+#ifdef _WIN32
+	_aligned_free(p_ptr);
+#else
+	std::free(p_ptr);
+#endif
+}
+
+//every form is replaced so that allocations and deallocations always match
+void* operator new  (std::size_t const p_size) { return tracked_alloc(p_size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new[](std::size_t const p_size) { return tracked_alloc(p_size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new  (std::size_t const p_size, std::align_val_t const p_alignment) { return tracked_alloc(p_size, static_cast<std::size_t>(p_alignment)); }
+void* operator new[](std::size_t const p_size, std::align_val_t const p_alignment) { return tracked_alloc(p_size, static_cast<std::size_t>(p_alignment)); }
+
+void operator delete  (void* const p_ptr) noexcept { tracked_free(p_ptr); }
+void operator delete[](void* const p_ptr) noexcept { tracked_free(p_ptr); }
+void operator delete  (void* const p_ptr, std::size_t) noexcept { tracked_free(p_ptr); }
+void operator delete[](void* const p_ptr, std::size_t) noexcept { tracked_free(p_ptr); }
+void operator delete  (void* const p_ptr, std::align_val_t) noexcept { tracked_free(p_ptr); }
+void operator delete[](void* const p_ptr, std::align_val_t) noexcept { tracked_free(p_ptr); }
+void operator delete  (void* const p_ptr, std::size_t, std::align_val_t) noexcept { tracked_free(p_ptr); }
+void operator delete[](void* const p_ptr, std::size_t, std::align_val_t) noexcept { tracked_free(p_ptr); }
+
+static std::u8string read_file(std::filesystem::path const& p_file)
+{
+	std::ifstream stream{p_file, std::ios::binary};
+	return std::u8string{std::istreambuf_iterator<char>{stream}, std::istreambuf_iterator<char>{}};
+}
+
+///	\brief Splits the lines of a file written by the file sinks, and strips the [date-time|thread]file(line) prefix
+static std::vector<std::u8string> file_messages(std::u8string_view const p_content)
+{
+	std::vector<std::u8string> out;
+	constexpr std::u8string_view level = u8") Info: "sv;
+	uintptr_t pos = 0;
+	while(pos < p_content.size())
+	{
+		uintptr_t const end = p_content.find(u8'\n', pos);
+		if(end == std::u8string_view::npos) break;
+		std::u8string_view const line = p_content.substr(pos, end - pos);
+		uintptr_t const start = line.find(level);
+		out.emplace_back(start == std::u8string_view::npos ? line : line.substr(start + level.size()));
+		pos = end + 1;
+	}
+	return out;
+}
+
 struct log_cache
 {
 	core::os_string file;
@@ -55,6 +164,7 @@ struct log_cache
 	std::u8string levelStr;
 	std::u8string message;
 
+	logger::log_site const* site;
 	void const*			module_base;
 	core::thread_id_t	thread_id;
 	uint32_t			line;
@@ -77,6 +187,7 @@ class test_sink: public logger::log_sink
 		cache.thread		= p_logData.sv_thread;
 		cache.levelStr		= p_logData.sv_level;
 		cache.message		= p_logData.message;
+		cache.site			= p_logData.site;
 		cache.module_base	= p_logData.module_base;
 		cache.module_name	= p_logData.module_name;
 		cache.thread_id		= p_logData.thread_id;
@@ -166,6 +277,9 @@ TEST(Logger, Logger_interface)
 			ASSERT_EQ(cache.thread_id, threadId) << "Case " << i;
 			ASSERT_EQ(cache.module_base, base_addr) << "Case " << i;
 			ASSERT_EQ(cache.module_name, mod_name) << "Case " << i;
+			ASSERT_NE(cache.site, nullptr) << "Case " << i;
+			ASSERT_EQ(cache.site->file, fileName) << "Case " << i;
+			ASSERT_EQ(cache.site->line, logLines[i]) << "Case " << i;
 			//TODO: need improvement
 			ASSERT_FALSE(cache.date.empty()) << "Case " << i; //Note might need better test
 			ASSERT_FALSE(cache.time.empty()) << "Case " << i; //Note might need better test
@@ -210,17 +324,40 @@ TEST(Logger, Logger_interface)
 #endif
 	}
 
+	{
+		test_sink tsink;
+		logger::log_add_sink(tsink);
+		uint32_t evaluated = 0;
+		LOG_VERBOSE("Verbose Test "sv, ++evaluated);
+		LOG_TRACE("Trace Test "sv, ++evaluated);
+		logger::log_remove_sink(tsink);
+#if LOGGER_MIN_LEVEL <= LOGGER_LEVEL_TRACE
+		ASSERT_EQ(tsink.m_log_cache.size(), 2_uip);
+		ASSERT_EQ(evaluated, 2_ui32);
+		ASSERT_EQ(tsink.m_log_cache[0].level, logger::Level::Verbose);
+		ASSERT_EQ(tsink.m_log_cache[0].levelStr, std::u8string_view{u8"Verbose"});
+		ASSERT_EQ(tsink.m_log_cache[1].level, logger::Level::Trace);
+		ASSERT_EQ(tsink.m_log_cache[1].levelStr, std::u8string_view{u8"Trace"});
+#else
+		//arguments of eliminated logs are not evaluated
+		ASSERT_TRUE(tsink.m_log_cache.empty());
+		ASSERT_EQ(evaluated, 0_ui32);
+#endif
+	}
+
 	{
 		test_sink tsink;
 		logger::log_add_sink(tsink);
 
 #ifdef _WIN32
 		core::os_string const fileName {L"Random Name"};
+		core::os_string_view const sourceName = std::wstring_view{__FILEW__};
 #else
 		core::os_string const fileName {"Random Name"};
+		core::os_string_view const sourceName = std::string_view{__FILE__};
 #endif
 
-		LOG_CUSTOM(fileName, 42, 7, logger::Level{0x12}, "Custom Test "sv, 32, ' ');
+		uint32_t const sourceLine = static_cast<uint32_t>(__LINE__); LOG_CUSTOM(fileName, 42, 7, logger::Level{0x12}, "Custom Test "sv, 32, ' ');
 
 		logger::log_remove_sink(tsink);
 		ASSERT_EQ(tsink.m_log_cache.size(), 1_uip);
@@ -234,6 +371,1586 @@ TEST(Logger, Logger_interface)
 		ASSERT_EQ(cache.column, 7_ui32);
 		ASSERT_EQ(cache.columnStr, std::u8string_view{u8"7"});
 		ASSERT_EQ(cache.file, fileName);
+		//the call site always refers to the source code
+		ASSERT_NE(cache.site, nullptr);
+		ASSERT_EQ(cache.site->file, sourceName);
+		ASSERT_EQ(cache.site->line, sourceLine);
+	}
+
+	{
+		test_sink tsink;
+		logger::log_add_sink(tsink);
+		for(uint32_t i = 0; i < 2; ++i)
+		{
+			LOG_INFO(i);
+		}
+		logger::log_remove_sink(tsink);
+
+		ASSERT_EQ(tsink.m_log_cache.size(), 2_uip);
+		ASSERT_EQ(tsink.m_log_cache[0].site, tsink.m_log_cache[1].site);
+	}
+}
+
+
+class test_deferred_sink: public logger::log_sink
+{
+	void output(logger::log_data const& p_logData)
+	{
+		std::u8string& message = m_messages.emplace_back();
+		if(p_logData.deferred_message.data())
+		{
+			message.resize(logger::deferred_format_size(p_logData.deferred_message));
+			logger::deferred_format(p_logData.deferred_message, message.data());
+		}
+		else
+		{
+			message = p_logData.message;
+		}
+
+		//the source is always available, its size is only computed when requested
+		std::u8string& rendered = m_rendered.emplace_back(p_logData.message_source->size(), u8'\0');
+		p_logData.message_source->render(rendered.data());
+	}
+
+	bool accepts_deferred() const { return true; }
+
+public:
+	std::vector<std::u8string> m_messages;
+	std::vector<std::u8string> m_rendered;
+};
+
+TEST(Logger, Logger_deferred)
+{
+	static_assert(logger::is_deferred_encodable_v<std::string_view, int32_t, uint64_t, double, char, char8_t, int8_t>);
+	static_assert(!logger::is_deferred_encodable_v<TestStr>);
+
+	logger::log_message_data data;
+	data.site        = nullptr;
+	data.module_base = core::get_current_module_base();
+	data.user_token  = nullptr;
+	data.module_name = core::get_current_module_name();
+	data.file        = core::os_string_view{};
+	data.line        = static_cast<uint32_t>(__LINE__);
+	data.column      = 0;
+	data.level       = logger::Level::Info;
+
+	{
+		test_deferred_sink dsink;
+		logger::log_add_sink(dsink);
+		logger::_p::log_deferred(data, "Combination "sv, 32, ' ', int8_t{-5}, u8"u8"sv);
+		logger::_p::log_deferred(data);
+		logger::log_remove_sink(dsink);
+
+		ASSERT_EQ(dsink.m_messages.size(), 2_uip);
+		ASSERT_EQ(dsink.m_messages[0], std::u8string_view{u8"Combination 32 -5u8"});
+		ASSERT_EQ(dsink.m_messages[1], std::u8string_view{u8""});
+		ASSERT_EQ(dsink.m_rendered, dsink.m_messages);
+	}
+
+	{
+		//sinks that can not handle deferred messages receive them already formatted
+		test_deferred_sink dsink;
+		test_sink tsink;
+		logger::log_add_sink(dsink);
+		logger::log_add_sink(tsink);
+		logger::_p::log_deferred(data, "Mixed "sv, 1.5, ' ', 7_ui32);
+		logger::_p::log_deferred(data, "Fallback "sv, TestStr{});
+		logger::log_remove_all();
+
+		ASSERT_EQ(dsink.m_messages.size(), 2_uip);
+		ASSERT_EQ(tsink.m_log_cache.size(), 2_uip);
+		ASSERT_EQ(dsink.m_messages[0], tsink.m_log_cache[0].message);
+		ASSERT_EQ(dsink.m_messages[1], std::u8string_view{u8"Fallback TestStr"});
+		ASSERT_EQ(tsink.m_log_cache[1].message, std::u8string_view{u8"Fallback TestStr"});
+	}
+}
+
+class test_filter: public logger::log_filter
+{
+public:
+	bool filter(logger::log_filter_data const& p_data) const override
+	{
+		++m_calls;
+		return p_data.level != logger::Level::Warning;
+	}
+
+	mutable uint32_t m_calls = 0;
+};
+
+TEST(Logger, Logger_filter)
+{
+	test_sink tsink;
+	test_filter tfilter;
+	logger::log_add_sink(tsink);
+	logger::log_set_filter(tfilter);
+
+	for(uint32_t i = 0; i < 3; ++i)
+	{
+		LOG_INFO(i);
+		LOG_WARNING(i);
+	}
+	//verdicts are cached per call site
+	ASSERT_EQ(tfilter.m_calls, 2_ui32);
+	ASSERT_EQ(tsink.m_log_cache.size(), 3_uip);
+
+	//changing the filter invalidates the cached verdicts
+	logger::log_reset_filter(false);
+	for(uint32_t i = 0; i < 3; ++i)
+	{
+		LOG_INFO(i);
+	}
+	ASSERT_EQ(tsink.m_log_cache.size(), 3_uip);
+
+	logger::log_set_filter(tfilter);
+	for(uint32_t i = 0; i < 3; ++i)
+	{
+		LOG_INFO(i);
+	}
+	ASSERT_EQ(tfilter.m_calls, 3_ui32);
+	ASSERT_EQ(tsink.m_log_cache.size(), 6_uip);
+
+	logger::log_reset_filter(true);
+	logger::log_remove_sink(tsink);
+}
+
+class test_fields_sink: public logger::log_sink
+{
+	void output(logger::log_data const& p_logData)
+	{
+		m_level.emplace_back(p_logData.sv_level);
+		m_date .emplace_back(p_logData.sv_date);
+		m_text .emplace_back(p_logData.message);
+
+		std::u8string& message = m_message.emplace_back();
+		message.resize(p_logData.message_source->size());
+		p_logData.message_source->render(message.data());
+	}
+
+	logger::log_field required_fields() const { return logger::log_field::level; }
+
+public:
+	std::vector<std::u8string> m_level;
+	std::vector<std::u8string> m_date;
+	std::vector<std::u8string> m_text;
+	std::vector<std::u8string> m_message;
+};
+
+TEST(Logger, Logger_fields)
+{
+	test_fields_sink fsink;
+	logger::log_add_sink(fsink);
+	LOG_INFO("level only "sv, 1);
+
+	//fields are rendered for the union of all sinks
+	test_sink tsink;
+	logger::log_add_sink(tsink);
+	LOG_INFO("all "sv, 2);
+
+	logger::log_remove_sink(tsink);
+	LOG_INFO("level only "sv, 3);
+	logger::log_remove_sink(fsink);
+
+	ASSERT_EQ(fsink.m_level.size(), 3_uip);
+	ASSERT_EQ(fsink.m_level[0], std::u8string_view{u8"Info"});
+	ASSERT_TRUE(fsink.m_date[0].empty());
+	ASSERT_FALSE(fsink.m_date[1].empty());
+	ASSERT_EQ(fsink.m_date[1], tsink.m_log_cache[0].date);
+	ASSERT_TRUE(fsink.m_date[2].empty());
+
+	//the message is always available to be rendered by the sink, as text only if required
+	ASSERT_EQ(fsink.m_message[0], std::u8string_view{u8"level only 1"});
+	ASSERT_EQ(fsink.m_message[1], std::u8string_view{u8"all 2"});
+	ASSERT_EQ(fsink.m_message[2], std::u8string_view{u8"level only 3"});
+	ASSERT_TRUE(fsink.m_text[0].empty());
+	ASSERT_EQ(fsink.m_text[1], std::u8string_view{u8"all 2"});
+	ASSERT_TRUE(fsink.m_text[2].empty());
+}
+
+TEST(Logger, Logger_clock)
+{
+	using namespace std::chrono;
+
+	logger::log_clock_calibration clock;
+	clock.calibrate();
+
+	system_clock::time_point const before = system_clock::now();
+	uint64_t const ticks_1 = logger::log_clock_ticks();
+	uint64_t const ticks_2 = logger::log_clock_ticks();
+	system_clock::time_point const after = system_clock::now();
+
+	logger::log_system_time const time_1 = clock.to_system_time(ticks_1);
+	logger::log_system_time const time_2 = clock.to_system_time(ticks_2);
+	ASSERT_LE(time_1, time_2);
+
+	//allow for the imprecision of a short calibration and the resolution of the system clock
+	constexpr milliseconds tolerance{50};
+	ASSERT_GE(time_1 + tolerance, before);
+	ASSERT_LE(time_2, after + tolerance);
+
+	//the conversion continues across a refresh
+	std::this_thread::sleep_for(milliseconds{1100});
+	uint64_t const ticks_3 = logger::log_clock_ticks();
+	logger::log_system_time const time_3 = clock.to_system_time(ticks_3);
+	clock.refresh();
+	logger::log_system_time const time_4 = clock.to_system_time(logger::log_clock_ticks());
+	ASSERT_LE(time_3, time_4);
+	ASSERT_LE(time_4, system_clock::now() + tolerance);
+	ASSERT_GE(time_4 + tolerance, system_clock::now());
+}
+
+TEST(Logger, Logger_time_fields)
+{
+	using namespace std::chrono;
+
+	test_sink tsink;
+	logger::log_add_sink(tsink);
+
+	//log continuously across a second boundary
+	sys_seconds const boundary = ceil<seconds>(system_clock::now() + milliseconds{20});
+	std::this_thread::sleep_until(boundary - milliseconds{10});
+
+	std::vector<std::pair<system_clock::time_point, system_clock::time_point>> reference;
+	while(system_clock::now() < boundary + milliseconds{10})
+	{
+		system_clock::time_point const before = system_clock::now();
+		LOG_INFO("time"sv);
+		reference.emplace_back(before, system_clock::now());
+	}
+	logger::log_remove_sink(tsink);
+
+	ASSERT_EQ(tsink.m_log_cache.size(), reference.size());
+	bool crossed = false;
+	for(uintptr_t i = 0; i < reference.size(); ++i)
+	{
+		core::date_time_t const& time_struct = tsink.m_log_cache[i].time_struct;
+		system_clock::time_point const logged =
+			sys_days{year{time_struct.date.year} / month{time_struct.date.month} / day{time_struct.date.day}}
+			+ hours{time_struct.time.hour} + minutes{time_struct.time.minute} + seconds{time_struct.time.second}
+			+ duration_cast<system_clock::duration>(nanoseconds{time_struct.time.nsecond});
+
+		ASSERT_GE(logged, reference[i].first) << "Record " << i;
+		ASSERT_LE(logged, reference[i].second) << "Record " << i;
+		crossed |= logged >= boundary;
+	}
+	ASSERT_TRUE(crossed);
+}
+
+class test_batch_sink: public logger::log_sink
+{
+	void output(logger::log_data const&)
+	{
+		++m_single;
+	}
+
+	void output_batch(std::span<logger::log_data const> const p_records)
+	{
+		++m_batches;
+		for(logger::log_data const& record: p_records)
+		{
+			std::u8string& message = m_messages.emplace_back();
+			message.resize(record.message_source->size());
+			record.message_source->render(message.data());
+		}
+	}
+
+public:
+	uint32_t m_single = 0;
+	uint32_t m_batches = 0;
+	std::vector<std::u8string> m_messages;
+};
+
+TEST(Logger, Logger_batch)
+{
+	logger::log_message_data data;
+	data.site        = nullptr;
+	data.module_base = core::get_current_module_base();
+	data.user_token  = nullptr;
+	data.module_name = core::get_current_module_name();
+	data.file        = core::os_string_view{};
+	data.line        = static_cast<uint32_t>(__LINE__);
+	data.column      = 0;
+	data.level       = logger::Level::Info;
+
+	//larger than what the logger prepares at once
+	constexpr uint32_t record_count = 40;
+	std::vector<logger::_p::message_printer<std::string_view, uint32_t>> printers;
+	std::vector<logger::log_message_record> records;
+	printers.reserve(record_count);
+	for(uint32_t i = 0; i < record_count; ++i)
+	{
+		logger::log_message_record& record = records.emplace_back();
+		record.data = data;
+		record.message = &printers.emplace_back("Batch "sv, i);
+	}
+
+	test_batch_sink bsink;
+	test_sink tsink;
+	logger::log_add_sink(bsink);
+	logger::log_add_sink(tsink);
+	logger::log_message_batch(records);
+	logger::log_remove_all();
+
+	ASSERT_EQ(bsink.m_single, 0_ui32);
+	ASSERT_GE(bsink.m_batches, 1_ui32);
+	ASSERT_EQ(bsink.m_messages.size(), uintptr_t{record_count});
+	//sinks that do not handle batches receive the records one by one
+	ASSERT_EQ(tsink.m_log_cache.size(), uintptr_t{record_count});
+	for(uint32_t i = 0; i < record_count; ++i)
+	{
+		std::string const expected = "Batch " + std::to_string(i);
+		ASSERT_EQ(bsink.m_messages[i], (std::u8string_view{reinterpret_cast<char8_t const*>(expected.data()), expected.size()})) << "Case " << i;
+		ASSERT_EQ(tsink.m_log_cache[i].message, bsink.m_messages[i]) << "Case " << i;
+	}
+}
+
+class test_counting_sink: public logger::log_sink
+{
+	void output(logger::log_data const&)
+	{
+		m_count.fetch_add(1, std::memory_order::relaxed);
+	}
+
+	logger::log_field required_fields() const { return logger::log_field::none; }
+
+public:
+	std::atomic<uint32_t> m_count = 0;
+};
+
+TEST(Logger, Logger_live_sinks)
+{
+	std::atomic<bool> quit = false;
+	std::vector<std::thread> producers;
+	for(uint32_t i = 0; i < 4; ++i)
+	{
+		producers.emplace_back(
+			[&quit]()
+			{
+				while(!quit.load(std::memory_order::relaxed))
+				{
+					LOG_INFO("live"sv);
+				}
+			});
+	}
+
+	test_counting_sink base_sink;
+	logger::log_add_sink(base_sink);
+	for(uint32_t i = 0; i < 200; ++i)
+	{
+		test_counting_sink sink;
+		logger::log_add_sink(sink);
+		logger::log_remove_sink(sink);
+		//once removed the sink is no longer in use
+		uint32_t const count = sink.m_count.load(std::memory_order::relaxed);
+		std::this_thread::yield();
+		ASSERT_EQ(sink.m_count.load(std::memory_order::relaxed), count);
+	}
+	logger::log_remove_sink(base_sink);
+
+	quit.store(true, std::memory_order::relaxed);
+	for(std::thread& producer: producers)
+	{
+		producer.join();
+	}
+	ASSERT_GT(base_sink.m_count.load(std::memory_order::relaxed), 0_ui32);
+}
+
+TEST(Logger, Logger_sink_filter)
+{
+	static_assert(logger::level_rank(logger::Level::Trace) < logger::level_rank(logger::Level::Verbose));
+	static_assert(logger::level_rank(logger::Level::Debug) < logger::level_rank(logger::Level::Info));
+	static_assert(logger::level_rank(logger::Level::Warning) < logger::level_rank(logger::Level::Error));
+
+	test_sink warning_sink;
+	test_sink all_sink;
+	test_filter tfilter;
+	logger::log_add_sink(warning_sink, logger::log_sink_filter{.min_level = logger::Level::Warning});
+	logger::log_add_sink(all_sink);
+	logger::log_set_filter(tfilter);
+
+	LOG_INFO("info"sv);
+	LOG_ERROR("error"sv);
+	ASSERT_EQ(warning_sink.m_log_cache.size(), 1_uip);
+	ASSERT_EQ(all_sink.m_log_cache.size(), 2_uip);
+	ASSERT_EQ(warning_sink.m_log_cache[0].message, std::u8string_view{u8"error"});
+
+	//logs no sink accepts are rejected without consulting the filter
+	logger::log_remove_sink(all_sink);
+	uint32_t const calls = tfilter.m_calls;
+	LOG_INFO("info"sv);
+	ASSERT_EQ(tfilter.m_calls, calls);
+	ASSERT_EQ(warning_sink.m_log_cache.size(), 1_uip);
+
+	//sinks restricted to another module
+	static int const other_module = 0;
+	ASSERT_TRUE(logger::log_set_sink_filter(warning_sink, logger::log_sink_filter{.min_level = logger::Level::Trace, .module_base = &other_module}));
+	LOG_ERROR("error"sv);
+	ASSERT_EQ(warning_sink.m_log_cache.size(), 1_uip);
+	ASSERT_FALSE(logger::log_set_sink_filter(all_sink, logger::log_sink_filter{}));
+
+	logger::log_reset_filter(true);
+	logger::log_remove_all();
+}
+
+#ifdef _WIN32
+#	define TEST_OS_STR(Str) L ## Str
+#else
+#	define TEST_OS_STR(Str) Str
+#endif
+
+TEST(Logger, Logger_rule_filter)
+{
+	logger::log_rule_filter const filter{{
+			{.module_pattern = TEST_OS_STR("net*"), .file_pattern = {}, .line_min = 0, .line_max = std::numeric_limits<uint32_t>::max(), .min_level = logger::Level::Warning},
+			{.module_pattern = {}, .file_pattern = TEST_OS_STR("*/net/socket.?pp"), .line_min = 10, .line_max = 20, .min_level = logger::Level::Trace},
+			{.module_pattern = TEST_OS_STR("storage"), .file_pattern = TEST_OS_STR("src\\*"), .line_min = 0, .line_max = std::numeric_limits<uint32_t>::max(), .min_level = logger::Level::Error},
+		}, logger::Level::Info};
+
+	core::os_string_view const socket_file = TEST_OS_STR("project/net/socket.cpp");
+	core::os_string_view const disk_file   = TEST_OS_STR("src/disk.cpp");
+	int const network_base = 0;
+	int const storage_base = 0;
+
+	logger::log_filter_data data;
+	data.site        = nullptr;
+	data.user_token  = nullptr;
+	data.column      = 0;
+
+	auto const check = [&](void const* p_base, core::os_string_view p_module, core::os_string_view p_file, uint32_t p_line, logger::Level p_level)
+	{
+		data.module_base = p_base;
+		data.module_name = p_module;
+		data.file        = p_file;
+		data.line        = p_line;
+		data.level       = p_level;
+		return filter.filter(data);
+	};
+
+	for(uint8_t pass = 0; pass < 2; ++pass) //second pass uses the compiled table
+	{
+		ASSERT_FALSE(check(&network_base, TEST_OS_STR("network"), socket_file, 5, logger::Level::Info));
+		ASSERT_TRUE (check(&network_base, TEST_OS_STR("network"), socket_file, 5, logger::Level::Warning));
+		ASSERT_TRUE (check(&network_base, TEST_OS_STR("network"), socket_file, 15, logger::Level::Trace));
+		ASSERT_FALSE(check(&network_base, TEST_OS_STR("network"), socket_file, 21, logger::Level::Info));
+
+		ASSERT_FALSE(check(&storage_base, TEST_OS_STR("storage"), disk_file, 1, logger::Level::Warning));
+		ASSERT_TRUE (check(&storage_base, TEST_OS_STR("storage"), disk_file, 1, logger::Level::Error));
+
+		ASSERT_FALSE(check(nullptr, TEST_OS_STR("other"), disk_file, 1, logger::Level::Debug));
+		ASSERT_TRUE (check(nullptr, TEST_OS_STR("other"), disk_file, 1, logger::Level::Info));
+	}
+
+	test_sink tsink;
+	logger::log_add_sink(tsink);
+	logger::log_set_filter(filter);
+	LOG_DEBUG("rejected");
+	LOG_INFO("accepted");
+	logger::log_reset_filter(true);
+	logger::log_remove_sink(tsink);
+
+	ASSERT_EQ(tsink.m_log_cache.size(), 1_uip);
+}
+
+TEST(Logger, Logger_rate_limit)
+{
+	test_sink tsink;
+	logger::log_add_sink(tsink);
+
+	for(uint32_t i = 0; i < 10; ++i)
+	{
+		LOG_EVERY_N(logger::Level::Info, 4, "every "sv, i);
+	}
+	ASSERT_EQ(tsink.m_log_cache.size(), 3_uip);
+	ASSERT_EQ(tsink.m_log_cache[1].message, std::u8string_view{u8"every 4"});
+	tsink.m_log_cache.clear();
+
+	for(uint32_t i = 0; i < 10; ++i)
+	{
+		LOG_FIRST_N(logger::Level::Info, 2, "first "sv, i);
+		LOG_ONCE(logger::Level::Info, "once "sv, i);
+	}
+	ASSERT_EQ(tsink.m_log_cache.size(), 3_uip);
+	ASSERT_EQ(tsink.m_log_cache[0].message, std::u8string_view{u8"first 0"});
+	ASSERT_EQ(tsink.m_log_cache[1].message, std::u8string_view{u8"once 0"});
+	ASSERT_EQ(tsink.m_log_cache[2].message, std::u8string_view{u8"first 1"});
+	tsink.m_log_cache.clear();
+
+	//the bucket is refilled at 1 log per second, the loop takes far less than that
+	for(uint32_t i = 0; i < 100; ++i)
+	{
+		LOG_RATE_LIMITED(logger::Level::Info, 1, 5, "rate "sv, i);
+	}
+	ASSERT_EQ(tsink.m_log_cache.size(), 5_uip);
+	tsink.m_log_cache.clear();
+
+	for(uint32_t i = 0; i < 100; ++i)
+	{
+		LOG_SAMPLED(logger::Level::Info, 0.0, "never"sv);
+		LOG_SAMPLED(logger::Level::Info, 1.0, "always"sv);
+	}
+	ASSERT_EQ(tsink.m_log_cache.size(), 100_uip);
+	tsink.m_log_cache.clear();
+
+	for(uint32_t i = 0; i < 10000; ++i)
+	{
+		LOG_SAMPLED(logger::Level::Info, 0.5, "half"sv);
+	}
+	ASSERT_GT(tsink.m_log_cache.size(), 4000_uip);
+	ASSERT_LT(tsink.m_log_cache.size(), 6000_uip);
+
+	logger::log_remove_sink(tsink);
+}
+
+class test_kv_sink: public logger::log_sink
+{
+	void output(logger::log_data const& p_logData)
+	{
+		m_text.emplace_back(p_logData.message);
+
+		std::u8string& json = m_json.emplace_back();
+		json.resize(logger::log_kv_json_size(p_logData.kv));
+		logger::log_kv_format_json(p_logData.kv, json.data());
+
+		logger::log_kv_reader reader{p_logData.kv};
+		logger::log_kv_entry entry;
+		while(reader.next(entry))
+		{
+			m_keys.emplace_back(entry.key);
+		}
+	}
+
+public:
+	std::vector<std::u8string> m_text;
+	std::vector<std::u8string> m_json;
+	std::vector<std::u8string> m_keys;
+};
+
+TEST(Logger, Logger_kv)
+{
+	test_kv_sink ksink;
+	logger::log_add_sink(ksink);
+
+	uint32_t const user = 42;
+	double const latency = 1.5;
+	LOG_INFO_KV("Request done", "user", user, "latency_us"sv, latency, "path", "/a \"b\"", "mark", 'x');
+	LOG_INFO_KV("Nothing else"sv);
+	LOG_INFO("Not structured"sv);
+
+	logger::log_remove_sink(ksink);
+
+	ASSERT_EQ(ksink.m_text.size(), 3_uip);
+	ASSERT_EQ(ksink.m_text[0], std::u8string_view{u8"Request done user=42 latency_us=1.5 path=\"/a \\\"b\\\"\" mark=\"x\""});
+	ASSERT_EQ(ksink.m_json[0], std::u8string_view{u8"{\"message\":\"Request done\",\"user\":42,\"latency_us\":1.5,\"path\":\"/a \\\"b\\\"\",\"mark\":\"x\"}"});
+	ASSERT_EQ(ksink.m_text[1], std::u8string_view{u8"Nothing else"});
+	ASSERT_EQ(ksink.m_json[1], std::u8string_view{u8"{\"message\":\"Nothing else\"}"});
+	ASSERT_EQ(ksink.m_text[2], std::u8string_view{u8"Not structured"});
+	ASSERT_EQ(ksink.m_keys.size(), 4_uip);
+	ASSERT_EQ(ksink.m_keys[3], std::u8string_view{u8"mark"});
+}
+
+TEST(Logger, Logger_ring)
+{
+	//records of every size up to the maximum, forcing the ring to wrap at every position
+	logger::_p::spsc_ring ring{0x400};
+	uintptr_t const max_size = ring.max_record_size();
+	constexpr uint32_t count = 20000;
+
+	std::thread producer{[&]()
+		{
+			for(uint32_t i = 0; i < count; ++i)
+			{
+				uintptr_t const size = sizeof(uint32_t) + i % (max_size - sizeof(uint32_t) + 1);
+				std::byte* slot;
+				while((slot = ring.reserve(size)) == nullptr)
+				{
+					ring.commit();
+					std::this_thread::yield();
+				}
+				memcpy(slot, &i, sizeof(uint32_t));
+				memset(slot + sizeof(uint32_t), static_cast<int>(i & 0xFF), size - sizeof(uint32_t));
+				if(i % 7 == 0) ring.commit();
+			}
+			ring.commit();
+		}};
+
+	uint32_t expected = 0;
+	bool valid = true;
+	while(expected < count && valid)
+	{
+		std::span<std::byte> const slot = ring.front();
+		if(slot.empty())
+		{
+			std::this_thread::yield();
+			continue;
+		}
+		uint32_t index;
+		memcpy(&index, slot.data(), sizeof(uint32_t));
+		valid = index == expected && slot.size() == sizeof(uint32_t) + index % (max_size - sizeof(uint32_t) + 1);
+		for(uintptr_t i = sizeof(uint32_t); valid && i < slot.size(); ++i)
+		{
+			valid = slot[i] == static_cast<std::byte>(index & 0xFF);
+		}
+		ring.pop();
+		++expected;
 	}
+	producer.join();
+
+	ASSERT_TRUE(valid);
+	ASSERT_EQ(expected, count);
+	ASSERT_TRUE(ring.empty());
 }
 
+TEST(Logger, Logger_record_pool)
+{
+	logger::_p::record_pool pool;
+
+	//buffers are recycled within their size class
+	std::byte* const small = pool.acquire(100);
+	std::byte* const medium = pool.acquire(0x3000);
+	ASSERT_NE(small, medium);
+	memset(small, 0xAA, 100);
+	memset(medium, 0xBB, 0x3000);
+	pool.release(small, 100);
+	pool.release(medium, 0x3000);
+	ASSERT_EQ(pool.acquire(0x1000), small);
+	ASSERT_EQ(pool.acquire(0x2001), medium);
+	ASSERT_NE(pool.acquire(0x1000), small);
+
+	//reserved buffers are used before allocating new ones
+	pool.reserve(0x10000, 2);
+	std::byte* const reserved_1 = pool.acquire(0x10000);
+	std::byte* const reserved_2 = pool.acquire(0x9000);
+	ASSERT_NE(reserved_1, reserved_2);
+	pool.release(reserved_1, 0x10000);
+	pool.release(reserved_2, 0x9000);
+
+	//larger than the largest size class, not pooled
+	std::byte* const large = pool.acquire(0x4000001);
+	memset(large, 0xCC, 0x4000001);
+	pool.release(large, 0x4000001);
+
+	//buffers acquired by one thread and released by another
+	constexpr uint32_t count = 10000;
+	std::atomic<std::byte*> handoff = nullptr;
+	std::thread consumer{[&]()
+		{
+			for(uint32_t i = 0; i < count; ++i)
+			{
+				std::byte* buffer;
+				while((buffer = handoff.exchange(nullptr, std::memory_order::acquire)) == nullptr)
+				{
+					std::this_thread::yield();
+				}
+				uintptr_t size;
+				memcpy(&size, buffer, sizeof(uintptr_t));
+				pool.release(buffer, size);
+			}
+		}};
+	for(uint32_t i = 0; i < count; ++i)
+	{
+		uintptr_t const size = 0x1000 + (i % 4) * 0x1800;
+		std::byte* const buffer = pool.acquire(size);
+		memcpy(buffer, &size, sizeof(uintptr_t));
+		while(handoff.load(std::memory_order::relaxed) != nullptr)
+		{
+			std::this_thread::yield();
+		}
+		handoff.store(buffer, std::memory_order::release);
+	}
+	consumer.join();
+}
+
+TEST(Logger, Logger_flush_control)
+{
+	using namespace std::chrono;
+	using logger::_p::flush_control;
+	using action = flush_control::action;
+	using time_point = flush_control::clock::time_point;
+
+	flush_control control;
+
+	//nothing is flushed by default
+	{
+		control.init(logger::log_flush_policy{});
+		time_point const now = flush_control::clock::now();
+		ASSERT_EQ(control.on_write(0x100000, true, now), action::none);
+		ASSERT_EQ(control.on_timer(now + hours{1}), action::none);
+		ASSERT_EQ(control.deadline(), time_point::max());
+	}
+
+	//bytes
+	{
+		control.init(logger::log_flush_policy{.flush_bytes = 100});
+		time_point const now = flush_control::clock::now();
+		ASSERT_EQ(control.on_write(60, false, now), action::none);
+		ASSERT_EQ(control.on_write(50, false, now), action::flush);
+		ASSERT_EQ(control.on_write(99, false, now), action::none);
+		ASSERT_EQ(control.deadline(), time_point::max());
+	}
+
+	//interval
+	{
+		control.init(logger::log_flush_policy{.flush_interval = milliseconds{100}});
+		time_point const now = flush_control::clock::now();
+		ASSERT_EQ(control.deadline(), time_point::max());
+		ASSERT_EQ(control.on_write(10, false, now), action::none);
+		ASSERT_EQ(control.deadline(), now + milliseconds{100});
+		ASSERT_EQ(control.on_write(10, false, now + milliseconds{50}), action::none);
+		ASSERT_EQ(control.deadline(), now + milliseconds{100});
+		ASSERT_EQ(control.on_timer(now + milliseconds{99}), action::none);
+		ASSERT_EQ(control.on_timer(now + milliseconds{100}), action::flush);
+		ASSERT_EQ(control.deadline(), time_point::max());
+		ASSERT_EQ(control.on_timer(now + milliseconds{300}), action::none);
+		ASSERT_EQ(control.on_write(10, false, now + milliseconds{400}), action::none);
+		ASSERT_EQ(control.on_write(10, false, now + milliseconds{500}), action::flush);
+	}
+
+	//errors
+	{
+		control.init(logger::log_flush_policy{.flush_on_error = true});
+		time_point const now = flush_control::clock::now();
+		ASSERT_EQ(control.on_write(10, false, now), action::none);
+		ASSERT_EQ(control.on_write(10, true, now), action::flush);
+
+		control.init(logger::log_flush_policy{});
+		ASSERT_EQ(control.on_write(10, true, now), action::none);
+	}
+
+	//sync, data flushed in between is synced once the interval expires
+	{
+		time_point const before = flush_control::clock::now();
+		control.init(logger::log_flush_policy{.flush_interval = milliseconds{100}, .sync_interval = seconds{1}});
+		time_point const now = flush_control::clock::now();
+
+		ASSERT_EQ(control.on_write(10, false, now), action::none);
+		ASSERT_EQ(control.deadline(), now + milliseconds{100});
+		ASSERT_EQ(control.on_timer(now + milliseconds{100}), action::flush);
+		ASSERT_GE(control.deadline(), before + seconds{1});
+		ASSERT_LE(control.deadline(), now + seconds{1});
+		ASSERT_EQ(control.on_timer(now + milliseconds{500}), action::none);
+		ASSERT_EQ(control.on_timer(now + seconds{1}), action::sync);
+		ASSERT_EQ(control.deadline(), time_point::max());
+
+		//the sync interval also applies to writes
+		ASSERT_EQ(control.on_write(10, false, now + milliseconds{1500}), action::none);
+		ASSERT_EQ(control.on_write(10, false, now + seconds{2}), action::sync);
+	}
+
+	//errors are synced immediately when syncing is enabled
+	{
+		control.init(logger::log_flush_policy{.flush_on_error = true, .sync_interval = seconds{10}});
+		time_point const now = flush_control::clock::now();
+		ASSERT_EQ(control.on_write(10, true, now), action::sync);
+		ASSERT_EQ(control.on_write(10, false, now), action::none);
+		ASSERT_EQ(control.deadline(), now + seconds{10});
+	}
+}
+
+TEST(Logger, Logger_async_merge)
+{
+	std::filesystem::path const file = std::filesystem::temp_directory_path() / "Logger_async_merge.log";
+	constexpr uint32_t thread_count = 4;
+	constexpr uint32_t count = 2000;
+
+	//small thread buffers, records wrap often and the large ones are stored outside of the buffers
+	std::u8string const large(0x1000, u8'x');
+	std::u8string_view const large_view = large;
+
+	logger::log_async_file_sink asink;
+	asink.set_repeat_suppression(std::chrono::milliseconds{0});
+	asink.set_clock_source(logger::log_clock_source::ticks);
+	ASSERT_TRUE(asink.init(file, 0x1000));
+	logger::log_add_sink(asink);
+
+	std::vector<std::thread> threads;
+	for(uint32_t t = 0; t < thread_count; ++t)
+	{
+		threads.emplace_back([t, large_view]()
+			{
+				for(uint32_t i = 0; i < count; ++i)
+				{
+					if(i % 50 == 0)
+					{
+						LOG_INFO(t, ' ', i, ' ', large_view);
+					}
+					else
+					{
+						LOG_INFO(t, ' ', i);
+					}
+				}
+			});
+	}
+	for(std::thread& thread: threads)
+	{
+		thread.join();
+	}
+	logger::log_remove_sink(asink);
+	asink.end();
+
+	std::vector<std::u8string> const messages = file_messages(read_file(file));
+
+	//the buffers of the previous session are released, the sink can be reused
+	asink.set_clock_source(logger::log_clock_source::system);
+	ASSERT_TRUE(asink.init(file, 0x1000));
+	logger::log_add_sink(asink);
+	LOG_INFO("reopened"sv);
+	logger::log_remove_sink(asink);
+	asink.end();
+	std::vector<std::u8string> const reopened = file_messages(read_file(file));
+	std::filesystem::remove(file);
+
+	//every record exactly once, in the order each thread logged them
+	ASSERT_EQ(messages.size(), thread_count * count);
+	std::array<uint32_t, thread_count> next{};
+	for(std::u8string const& message: messages)
+	{
+		uint32_t const t = static_cast<uint32_t>(message[0] - u8'0');
+		ASSERT_LT(t, thread_count);
+		std::u8string expected = std::u8string{message[0]} + u8' ' + std::u8string{reinterpret_cast<char8_t const*>(std::to_string(next[t]).c_str())};
+		if(next[t] % 50 == 0)
+		{
+			expected += u8' ';
+			expected += large;
+		}
+		ASSERT_EQ(message, expected);
+		++next[t];
+	}
+
+	ASSERT_EQ(reopened.size(), 1_uip);
+	ASSERT_EQ(reopened[0], u8"reopened"sv);
+}
+
+TEST(Logger, Logger_async_end_while_logging)
+{
+	std::filesystem::path const file = std::filesystem::temp_directory_path() / "Logger_async_end_while_logging.log";
+	constexpr uint32_t thread_count = 4;
+
+	//the sink is ended, and reopened, while threads are still logging to it,
+	//small thread buffers keep the threads waiting for the writer thread
+	logger::log_async_file_sink asink;
+	ASSERT_TRUE(asink.init(file, 0x1000));
+	logger::log_add_sink(asink);
+
+	std::atomic<bool> stop = false;
+	std::vector<std::thread> threads;
+	for(uint32_t t = 0; t < thread_count; ++t)
+	{
+		threads.emplace_back([t, &stop]()
+			{
+				for(uint32_t i = 0; !stop.load(std::memory_order::relaxed); ++i)
+				{
+					LOG_INFO(t, ' ', i);
+				}
+			});
+	}
+
+	for(uint32_t i = 0; i < 20; ++i)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds{2});
+		asink.end();
+		ASSERT_TRUE(asink.init(file, 0x1000));
+	}
+	std::this_thread::sleep_for(std::chrono::milliseconds{2});
+	asink.end();
+
+	stop.store(true, std::memory_order::relaxed);
+	for(std::thread& thread: threads)
+	{
+		thread.join();
+	}
+	logger::log_remove_sink(asink);
+
+	//records logged after end are discarded, the records before it are complete
+	std::u8string const content = read_file(file);
+	std::filesystem::remove(file);
+	ASSERT_TRUE(content.empty() || content.back() == u8'\n');
+	for(std::u8string const& message: file_messages(content))
+	{
+		ASSERT_LT(static_cast<uint32_t>(message[0] - u8'0'), thread_count);
+	}
+}
+
+TEST(Logger, Logger_async_repeats)
+{
+	std::filesystem::path const file = std::filesystem::temp_directory_path() / "Logger_async_repeats.log";
+	constexpr std::chrono::milliseconds timeout{200};
+
+	logger::log_async_file_sink asink;
+	asink.set_repeat_suppression(timeout);
+	ASSERT_TRUE(asink.init(file));
+	logger::log_add_sink(asink);
+
+	//a single call site, repetitions must match the site as well as the message
+	auto const log = [](std::u8string_view const p_message) { LOG_INFO(p_message); };
+
+	//reported once a different record arrives
+	for(uint32_t i = 0; i < 5; ++i)
+	{
+		log(u8"first"sv);
+	}
+	log(u8"second"sv);
+
+	//reported after the timeout, further repetitions are counted again
+	for(uint32_t i = 0; i < 3; ++i)
+	{
+		log(u8"third"sv);
+	}
+	std::this_thread::sleep_for(timeout * 3);
+	log(u8"third"sv);
+	log(u8"third"sv);
+
+	//reported by end
+	logger::log_remove_sink(asink);
+	asink.end();
+
+	std::vector<std::u8string> messages = file_messages(read_file(file));
+	std::filesystem::remove(file);
+
+	for(std::u8string& message: messages)
+	{
+		uintptr_t const pos = message.find(u8"] Last message repeated "sv);
+		if(pos != std::u8string::npos)
+		{
+			message.erase(0, pos + 2);
+		}
+	}
+
+	std::vector<std::u8string> const expected
+	{
+		u8"first",
+		u8"Last message repeated 4 times",
+		u8"second",
+		u8"third",
+		u8"Last message repeated 2 times",
+		u8"Last message repeated 2 times",
+	};
+	ASSERT_EQ(messages, expected);
+}
+
+TEST(Logger, Logger_async_repeated_errors)
+{
+	std::filesystem::path const file = std::filesystem::temp_directory_path() / "Logger_async_repeated_errors.log";
+
+	logger::log_async_file_sink asink;
+	asink.set_repeat_suppression(std::chrono::minutes{1});
+	asink.set_flush_policy(logger::log_flush_policy{.flush_on_error = true});
+	ASSERT_TRUE(asink.init(file));
+	logger::log_add_sink(asink);
+
+	auto const log = []() { LOG_ERROR("failed"sv); };
+	for(uint32_t i = 0; i < 3; ++i)
+	{
+		log();
+	}
+
+	//every error reaches the file without waiting for the repetitions to end
+	std::vector<std::u8string> const expected
+	{
+		u8"failed",
+		u8"Last message repeated 1 times",
+		u8"Last message repeated 1 times",
+	};
+	std::vector<std::u8string> messages;
+	for(uint32_t tries = 0; tries < 500 && messages.size() < expected.size(); ++tries)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds{10});
+		messages = file_messages(read_file(file));
+	}
+
+	logger::log_remove_sink(asink);
+	asink.end();
+	std::filesystem::remove(file);
+
+	for(std::u8string& message: messages)
+	{
+		uintptr_t const pos = message.find(u8"] Last message repeated "sv);
+		if(pos != std::u8string::npos)
+		{
+			message.erase(0, pos + 2);
+		}
+		constexpr std::u8string_view level = u8") Error: "sv;
+		uintptr_t const level_pos = message.find(level);
+		if(level_pos != std::u8string::npos)
+		{
+			message.erase(0, level_pos + level.size());
+		}
+	}
+	ASSERT_EQ(messages, expected);
+}
+
+TEST(Logger, Logger_async_batch)
+{
+	std::filesystem::path const file = std::filesystem::temp_directory_path() / "Logger_async_batch.log";
+
+	//small batches, records of varying layouts and reports of repetitions keep crossing the batch boundaries,
+	//and some records are larger than a batch
+	logger::log_async_file_sink asink;
+	asink.set_write_batch_size(256);
+	asink.set_repeat_suppression(std::chrono::minutes{1});
+	ASSERT_TRUE(asink.init(file));
+
+	constexpr std::array<std::pair<logger::Level, std::u8string_view>, 4> levels
+	{{
+		{logger::Level::Info,    u8"Info"},
+		{logger::Level::Warning, u8"Warning"},
+		{logger::Level::Error,   u8"Error"},
+		{logger::Level::Debug,   u8"Debug"},
+	}};
+	constexpr std::array<std::u8string_view, 3> threads{u8"1", u8"12345", u8"main thread"};
+
+	std::u8string expected;
+	std::vector<std::u8string> messages;
+	for(uint32_t i = 0; i < 300; ++i)
+	{
+		messages.emplace_back((i * 37) % 700, static_cast<char8_t>(u8'a' + i % 26));
+	}
+
+	for(uint32_t i = 0; i < messages.size(); ++i)
+	{
+		std::u8string const line   = reinterpret_cast<char8_t const*>(std::to_string(i * 97 % 100000).c_str());
+		std::u8string const column = reinterpret_cast<char8_t const*>(std::to_string(i % 5).c_str());
+		logger::_p::message_printer<std::u8string_view> const message{std::u8string_view{messages[i]}};
+
+		logger::log_data data;
+		data.site             = nullptr;
+		data.module_base      = nullptr;
+		data.user_token       = nullptr;
+		data.file             = TEST_OS_STR("src/batch.cpp");
+		data.line             = i * 97 % 100000;
+		data.column           = i % 5;
+		data.level            = levels[i % levels.size()].first;
+		data.timestamp        = 0;
+		data.sv_line          = line;
+		data.sv_column        = column;
+		data.sv_thread        = threads[i % threads.size()];
+		data.sv_level         = levels[i % levels.size()].second;
+		data.deferred_message = {};
+		data.message_source   = &message;
+
+		std::u8string record = std::u8string{u8"src/batch.cpp("} + line;
+		if(data.column)
+		{
+			record += u8',';
+			record += column;
+		}
+		record += u8") ";
+		record += data.sv_level;
+		record += u8": ";
+		record += messages[i];
+		record += u8'\n';
+
+		expected += u8'|';
+		expected += data.sv_thread;
+		expected += u8']';
+		expected += record;
+
+		//repetitions only differ by thread, which is not considered
+		asink.output(data);
+		uint32_t const repeats = i % 3;
+		for(uint32_t j = 0; j < repeats; ++j)
+		{
+			data.sv_thread = threads[(i + j + 1) % threads.size()];
+			asink.output(data);
+		}
+		if(repeats)
+		{
+			expected += u8"] Last message repeated ";
+			expected += reinterpret_cast<char8_t const*>(std::to_string(repeats).c_str());
+			expected += u8" times\n";
+		}
+	}
+	asink.end();
+
+	//the [date-time prefix is not compared
+	std::u8string const content = read_file(file);
+	std::filesystem::remove(file);
+
+	std::u8string output;
+	for(uintptr_t pos = 0; pos < content.size();)
+	{
+		uintptr_t const end = content.find(u8'\n', pos);
+		ASSERT_NE(end, std::u8string::npos);
+		std::u8string_view const line{content.data() + pos, end + 1 - pos};
+		uintptr_t const start = line.find_first_of(u8"|]");
+		ASSERT_NE(start, std::u8string_view::npos);
+		output += line.substr(start);
+		pos = end + 1;
+	}
+	ASSERT_TRUE(output == expected);
+}
+
+TEST(Logger, Logger_uring_writer)
+{
+	std::filesystem::path const file = std::filesystem::temp_directory_path() / "Logger_uring_writer.log";
+	std::string expected = "existing data|";
+	{
+		std::ofstream stream{file, std::ios::binary | std::ios::trunc};
+		stream << expected;
+	}
+
+	logger::_p::uring_writer writer;
+	if(!writer.open(file, logger::log_uring_config{.buffer_count = 3, .buffer_size = 1000}))
+	{
+		//io_uring is not available on this system, the sinks write synchronously
+		std::filesystem::remove(file);
+		return;
+	}
+
+	//small writes are gathered, large ones span several buffers, the data is appended after the existing content
+	for(uint32_t i = 0; i < 400; ++i)
+	{
+		std::string const chunk(i * 37 % 2500, static_cast<char>('a' + i % 26));
+		writer.write(chunk.data(), chunk.size());
+		expected += chunk;
+		if(i % 50 == 49)
+		{
+			writer.wait_all();
+			ASSERT_EQ(std::filesystem::file_size(file), expected.size());
+		}
+	}
+	writer.close();
+	ASSERT_FALSE(writer.is_open());
+
+	std::u8string const content = read_file(file);
+	ASSERT_TRUE(std::string_view(reinterpret_cast<char const*>(content.data()), content.size()) == expected);
+
+#ifdef __linux__
+	//once the ring stops working the data is written synchronously, the pending buffers included
+	{
+		//appended after the data written so far
+		expected = std::string{reinterpret_cast<char const*>(content.data()), content.size()};
+		ASSERT_TRUE(writer.open(file, logger::log_uring_config{.buffer_count = 3, .buffer_size = 1000}));
+		std::string const head = "head|";
+		writer.write(head.data(), head.size());
+		expected += head;
+		writer.wait_all();
+		ASSERT_FALSE(writer.failed());
+
+		//replaces the ring with a file that is not a ring, io_uring_enter then fails with EOPNOTSUPP
+		for(std::filesystem::directory_entry const& entry: std::filesystem::directory_iterator{"/proc/self/fd"})
+		{
+			std::error_code ec;
+			if(std::filesystem::read_symlink(entry.path(), ec).native().find("io_uring") != std::string::npos)
+			{
+				int const null_fd = ::open("/dev/null", O_WRONLY | O_CLOEXEC);
+				ASSERT_NE(null_fd, -1);
+				ASSERT_NE(::dup2(null_fd, std::stoi(entry.path().filename().native())), -1);
+				::close(null_fd);
+				break;
+			}
+		}
+
+		for(uint32_t i = 0; i < 50; ++i)
+		{
+			std::string const chunk(i * 37 % 2500, static_cast<char>('a' + i % 26));
+			writer.write(chunk.data(), chunk.size());
+			expected += chunk;
+		}
+		writer.wait_all();
+		ASSERT_TRUE(writer.failed());
+		writer.close();
+
+		std::u8string const fallback = read_file(file);
+		ASSERT_TRUE(std::string_view(reinterpret_cast<char const*>(fallback.data()), fallback.size()) == expected);
+	}
+
+	//failed writes are retried synchronously, and given up if that fails as well
+	if(writer.open("/dev/full", logger::log_uring_config{.buffer_count = 2, .buffer_size = 100}))
+	{
+		std::string const chunk(1000, 'x');
+		writer.write(chunk.data(), chunk.size());
+		writer.wait_all();
+		writer.close();
+	}
+#endif
+	std::filesystem::remove(file);
+}
+
+TEST(Logger, Logger_direct_writer)
+{
+	std::filesystem::path const file = std::filesystem::temp_directory_path() / "Logger_direct_writer.log";
+	std::string expected = "existing data, not aligned|";
+	{
+		std::ofstream stream{file, std::ios::binary | std::ios::trunc};
+		stream << expected;
+	}
+
+	logger::_p::direct_writer writer;
+	if(!writer.open(file, logger::log_direct_config{.buffer_count = 2, .buffer_size = 0x2000, .alignment = 0}))
+	{
+		//the file system does not support direct I/O, the sinks use their other backends
+		std::filesystem::remove(file);
+		return;
+	}
+
+	auto const write = [&](uint32_t const p_first, uint32_t const p_count)
+	{
+		for(uint32_t i = p_first; i < p_first + p_count; ++i)
+		{
+			std::string const chunk(i * 131 % 0x3001, static_cast<char>('a' + i % 26));
+			writer.write(chunk.data(), chunk.size());
+			expected += chunk;
+		}
+	};
+
+	auto const content = [&]()
+	{
+		std::u8string const data = read_file(file);
+		return std::string{reinterpret_cast<char const*>(data.data()), data.size()};
+	};
+
+	//after a flush the data is complete, the end of the file may hold the padding of the last block
+	write(0, 40);
+	writer.flush();
+	std::string const flushed = content();
+	ASSERT_GE(flushed.size(), expected.size());
+	ASSERT_TRUE(std::string_view{flushed}.substr(0, expected.size()) == expected);
+	ASSERT_EQ(flushed.find_first_not_of('\0', expected.size()), std::string::npos);
+
+	//the partial block is rewritten by the next writes, and the padding is trimmed on close
+	write(40, 40);
+	writer.flush();
+	write(80, 3);
+	writer.close();
+	ASSERT_FALSE(writer.is_open());
+
+	std::string const closed = content();
+	std::filesystem::remove(file);
+	ASSERT_EQ(closed.size(), expected.size());
+	ASSERT_TRUE(closed == expected);
+}
+
+TEST(Logger, Logger_mmap_file_sink)
+{
+	std::filesystem::path const file = std::filesystem::temp_directory_path() / "Logger_mmap_file_sink.log";
+	constexpr uint32_t thread_count = 2;
+	constexpr uint32_t count = 200;
+
+	//the smallest chunks, records keep crossing from one chunk to the next,
+	//and there are many more chunks than can be mapped at the same time
+	logger::log_mmap_file_sink msink;
+	ASSERT_TRUE(msink.init(file, 1));
+	logger::log_add_sink(msink);
+
+	std::vector<std::thread> threads;
+	for(uint32_t t = 0; t < thread_count; ++t)
+	{
+		threads.emplace_back([t]()
+			{
+				for(uint32_t i = 0; i < count; ++i)
+				{
+					std::u8string const padding(1000 + i * 37 % 5000, static_cast<char8_t>(u8'a' + i % 26));
+					LOG_INFO(t, ' ', i, ' ', std::u8string_view{padding});
+				}
+			});
+	}
+	for(std::thread& thread: threads)
+	{
+		thread.join();
+	}
+	logger::log_remove_sink(msink);
+	msink.end();
+
+	std::u8string const content = read_file(file);
+	uintmax_t const file_size = std::filesystem::file_size(file);
+	std::filesystem::remove(file);
+
+	//truncated to the data, no padding left from the last chunk
+	ASSERT_EQ(file_size, content.size());
+	ASSERT_GT(content.size(), 0x10000_uip * 8);
+	ASSERT_EQ(content.find(u8'\0'), std::u8string::npos);
+	ASSERT_EQ(content.back(), u8'\n');
+
+	std::vector<std::u8string> const messages = file_messages(content);
+	ASSERT_EQ(messages.size(), thread_count * count);
+	std::array<uint32_t, thread_count> next{};
+	for(std::u8string const& message: messages)
+	{
+		uint32_t const t = static_cast<uint32_t>(message[0] - u8'0');
+		ASSERT_LT(t, thread_count);
+		uint32_t const i = next[t]++;
+		std::u8string const expected = std::u8string{message[0]} + u8' ' + reinterpret_cast<char8_t const*>(std::to_string(i).c_str())
+			+ u8' ' + std::u8string(1000 + i * 37 % 5000, static_cast<char8_t>(u8'a' + i % 26));
+		ASSERT_TRUE(message == expected);
+	}
+}
+
+namespace
+{
+	///	\brief Copies the closed files, and remembers their names
+	class copy_compressor final: public logger::log_segment_compressor
+	{
+	public:
+		std::filesystem::path compress(std::filesystem::path const& p_segment) final
+		{
+			std::filesystem::path compressed = p_segment;
+			compressed += ".z";
+			std::filesystem::copy_file(p_segment, compressed);
+			segments.push_back(p_segment.filename());
+			calls.fetch_add(1, std::memory_order::release);
+			return compressed;
+		}
+
+		std::vector<std::filesystem::path> segments; //!< Only read once the sink has ended
+		std::atomic<uint32_t> calls = 0;
+	};
+
+	std::filesystem::path segment_name(uint64_t const p_number, bool const p_compressed)
+	{
+		std::string name = std::to_string(p_number);
+		name = "app." + std::string(6 - name.size(), '0') + name + (p_compressed ? ".log.z" : ".log");
+		return name;
+	}
+
+	///	\brief Logs records larger than the size limit until the compressor has been called p_rotations times,
+	///		the sink only rotates when the next file is ready
+	uint32_t log_until_rotated(copy_compressor const& p_compressor, uint32_t const p_rotations, uint32_t p_index)
+	{
+		for(uint32_t tries = 0; p_compressor.calls.load(std::memory_order::acquire) < p_rotations && tries < 5000; ++tries)
+		{
+			std::u8string const padding(300, static_cast<char8_t>(u8'a' + p_index % 26));
+			LOG_INFO(p_index, ' ', std::u8string_view{padding});
+			++p_index;
+			std::this_thread::sleep_for(std::chrono::milliseconds{1});
+		}
+		return p_index;
+	}
+
+	std::vector<std::filesystem::path> directory_files(std::filesystem::path const& p_directory)
+	{
+		std::vector<std::filesystem::path> files;
+		for(std::filesystem::directory_entry const& entry: std::filesystem::directory_iterator{p_directory})
+		{
+			files.push_back(entry.path().filename());
+		}
+		std::sort(files.begin(), files.end());
+		return files;
+	}
+} //namespace
+
+TEST(Logger, Logger_rotating_file_sink)
+{
+	std::filesystem::path const directory = std::filesystem::temp_directory_path() / "Logger_rotating_file_sink";
+	std::filesystem::remove_all(directory);
+	std::filesystem::create_directories(directory);
+	constexpr uint64_t max_size = 256;
+
+	//rotates by size, every closed file goes through the compressor
+	uint32_t logged = 0;
+	uint64_t first_run = 0;
+	{
+		copy_compressor compressor;
+		logger::log_rotating_file_sink rsink;
+		rsink.set_rotation_policy(logger::log_rotation_policy{.max_size = max_size});
+		rsink.set_compressor(&compressor);
+		ASSERT_TRUE(rsink.init(directory / "app.log"));
+		logger::log_add_sink(rsink);
+		logged = log_until_rotated(compressor, 3, 0);
+		logger::log_remove_sink(rsink);
+		rsink.end();
+
+		first_run = compressor.segments.size();
+		ASSERT_GE(first_run, uint64_t{3});
+
+		//the closed files are replaced by their compressed version, the file that was open when the sink ended is kept as is,
+		//and the file that was prepared but never written is removed
+		std::vector<std::filesystem::path> expected;
+		for(uint64_t i = 1; i <= first_run; ++i)
+		{
+			ASSERT_EQ(compressor.segments[i - 1], segment_name(i, false));
+			expected.push_back(segment_name(i, true));
+		}
+		expected.push_back(segment_name(first_run + 1, false));
+		ASSERT_EQ(directory_files(directory), expected);
+
+		//every record is in exactly one file, in order, and a file is only closed after reaching the size limit
+		std::vector<std::u8string> messages;
+		for(std::filesystem::path const& file: expected)
+		{
+			std::u8string const content = read_file(directory / file);
+			std::vector<std::u8string> const file_content = file_messages(content);
+			if(file != expected.back())
+			{
+				ASSERT_GE(content.size(), max_size);
+				ASSERT_FALSE(file_content.empty());
+			}
+			messages.insert(messages.end(), file_content.begin(), file_content.end());
+		}
+		ASSERT_EQ(messages.size(), logged);
+		for(uint32_t i = 0; i < logged; ++i)
+		{
+			std::u8string const expected_message = reinterpret_cast<char8_t const*>(std::to_string(i).c_str())
+				+ std::u8string{u8' '} + std::u8string(300, static_cast<char8_t>(u8'a' + i % 26));
+			ASSERT_TRUE(messages[i] == expected_message);
+		}
+	}
+
+	//a new run continues the numbering, and the retention also removes the files of the previous run
+	{
+		constexpr uint32_t retention = 2;
+		copy_compressor compressor;
+		logger::log_rotating_file_sink rsink;
+		rsink.set_rotation_policy(logger::log_rotation_policy{.max_size = max_size, .retention = retention});
+		rsink.set_compressor(&compressor);
+		ASSERT_TRUE(rsink.init(directory / "app.log"));
+		logger::log_add_sink(rsink);
+		log_until_rotated(compressor, 1, logged);
+		logger::log_remove_sink(rsink);
+		rsink.end();
+
+		uint64_t const second_run = compressor.segments.size();
+		ASSERT_GE(second_run, uint64_t{1});
+
+		std::vector<std::filesystem::path> closed;
+		for(uint64_t i = 1; i <= first_run; ++i)
+		{
+			closed.push_back(segment_name(i, true));
+		}
+		closed.push_back(segment_name(first_run + 1, false));
+		for(uint64_t i = 0; i < second_run; ++i)
+		{
+			ASSERT_EQ(compressor.segments[i], segment_name(first_run + 2 + i, false));
+			closed.push_back(segment_name(first_run + 2 + i, true));
+		}
+
+		std::vector<std::filesystem::path> expected{closed.end() - retention, closed.end()};
+		expected.push_back(segment_name(first_run + 2 + second_run, false));
+		std::sort(expected.begin(), expected.end());
+		ASSERT_EQ(directory_files(directory), expected);
+	}
+
+	std::filesystem::remove_all(directory);
+}
+
+TEST(Logger, Logger_flight_recorder)
+{
+	std::filesystem::path const file = std::filesystem::temp_directory_path() / "Logger_flight_recorder.bin";
+
+	logger::log_flight_recorder_sink fsink;
+	ASSERT_TRUE(fsink.init(file, 0x1000));
+	logger::log_add_sink(fsink);
+	for(uint32_t i = 0; i < 200; ++i)
+	{
+		LOG_INFO("record "sv, i);
+	}
+	logger::log_remove_sink(fsink);
+
+	//the file is read while still mapped, as it would be found after a crash
+	std::vector<std::u8string> records;
+	bool const read = logger::read_flight_recorder(file, 5, records);
+	fsink.end();
+	std::filesystem::remove(file);
+
+	ASSERT_TRUE(read);
+	ASSERT_EQ(records.size(), 5_uip);
+	for(uint32_t i = 0; i < 5; ++i)
+	{
+		std::u8string const expected = u8") Info: record 19" + std::u8string{static_cast<char8_t>(u8'5' + i)} + u8"\n";
+		ASSERT_TRUE(records[i].ends_with(expected));
+	}
+
+	std::vector<std::u8string> all;
+	ASSERT_FALSE(logger::read_flight_recorder(file, 0, all));
+}
+
+class test_alloc_sink: public logger::log_sink
+{
+	void output(logger::log_data const& p_logData)
+	{
+		m_size += p_logData.message.size();
+	}
+
+public:
+	uintptr_t m_size = 0;
+};
+
+TEST(Logger, Logger_no_alloc)
+{
+	std::filesystem::path const file       = std::filesystem::temp_directory_path() / "Logger_no_alloc.log";
+	std::filesystem::path const async_file = std::filesystem::temp_directory_path() / "Logger_no_alloc_async.log";
+	std::u8string const large(0x20000, u8'a');
+	std::u8string_view const large_view = large;
+
+	test_alloc_sink asink;
+	logger::log_add_sink(asink);
+
+	//the shipped sinks, the large records do not fit the thread buffer of the asynchronous sink and go through its pool
+	logger::log_file_sink fsink;
+	ASSERT_TRUE(fsink.init(file));
+	logger::log_add_sink(fsink);
+
+	logger::log_async_file_sink async_sink;
+	ASSERT_TRUE(async_sink.init(async_file, 0x1000));
+	async_sink.reserve_large_records(large.size() + 0x100, 64);
+	logger::log_add_sink(async_sink);
+
+	logger::log_console_sink csink;
+	logger::log_add_sink(csink);
+
+#ifdef __linux__
+	//the large records are not worth printing
+	fflush(stdout);
+	int const stdout_fd = ::dup(STDOUT_FILENO);
+	int const null_fd = ::open("/dev/null", O_WRONLY | O_CLOEXEC);
+	ASSERT_NE(stdout_fd, -1);
+	ASSERT_NE(null_fd, -1);
+	::dup2(null_fd, STDOUT_FILENO);
+	::close(null_fd);
+#endif
+
+	auto const log_all = [&]()
+	{
+		LOG_INFO("small "sv, 42, ' ', 1.5);
+		LOG_INFO("large "sv, large_view);
+		LOG_INFO_KV("structured", "key", 42);
+
+		logger::log_message_data data;
+		data.site        = nullptr;
+		data.module_base = nullptr;
+		data.user_token  = nullptr;
+		data.file        = core::os_string_view{};
+		data.line        = 0;
+		data.column      = 0;
+		data.level       = logger::Level::Info;
+		logger::_p::message_printer<std::u8string_view> const message{large_view};
+		std::array<logger::log_message_record, 2> const records{logger::log_message_record{data, &message}, logger::log_message_record{data, &message}};
+		logger::log_message_batch(records);
+
+		//rendered by the logger for the sinks that do not take deferred records
+		logger::_p::log_deferred(data, "deferred "sv, 7, ' ', large_view);
+	};
+
+	logger::log_prepare_thread(0x40000);
+	log_all();
+
+	t_allocations = 0;
+	t_track_allocations = true;
+	for(uint32_t i = 0; i < 10; ++i)
+	{
+		log_all();
+	}
+	t_track_allocations = false;
+
+	logger::log_remove_sink(csink);
+	logger::log_remove_sink(async_sink);
+	logger::log_remove_sink(fsink);
+	logger::log_remove_sink(asink);
+	async_sink.end();
+	fsink.end();
+
+#ifdef __linux__
+	fflush(stdout);
+	::dup2(stdout_fd, STDOUT_FILENO);
+	::close(stdout_fd);
+#endif
+
+	//every record reached the file sinks
+	std::vector<std::u8string> const messages = file_messages(read_file(file));
+	std::vector<std::u8string> const async_messages = file_messages(read_file(async_file));
+	std::filesystem::remove(file);
+	std::filesystem::remove(async_file);
+
+	ASSERT_EQ(t_allocations, 0_ui32);
+	ASSERT_EQ(asink.m_size, 11_uip * (4 * 0x20000 + 12 + 6 + 17 + 11));
+	ASSERT_EQ(messages.size(), 11_uip * 6);
+	ASSERT_EQ(async_messages, messages);
+}
@@ -38,6 +38,11 @@ public:
 	{
 		dump_output(std::string_view{reinterpret_cast<char const*>(p_logData.message.data()), p_logData.message.size()});
 	}
+
+	logger::log_field required_fields() const override
+	{
+		return logger::log_field::message;
+	}
 };
 
 static void logger_test_combo(benchmark::State& state)